@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Replays a generated stream of activate/terminate events, as the
+ * homescreen receives them from the compositor and applaunchd, against
+ * AppStack and against the QStringList the homescreen used before, and
+ * checks that both end up agreeing on the order of the applications.
+ *
+ * The stream is random but seeded, so runs are comparable; about one event
+ * in eight terminates an application, the rest activate one.
+ *
+ * Usage: appstack-bench [events] [applications] [outputs]
+ */
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "appstack.h"
+
+struct app_event {
+	bool terminate;
+	int app;
+	int output;
+};
+
+/* what HomescreenHandler did with its apps_stack, single output */
+static void
+legacy_activate(QStringList &apps_stack, const QString &app_id)
+{
+	if (!apps_stack.contains(app_id)) {
+		apps_stack << app_id;
+	} else {
+		int current_pos = apps_stack.indexOf(app_id);
+		int last_pos = apps_stack.size() - 1;
+
+		if (current_pos != last_pos)
+			apps_stack.move(current_pos, last_pos);
+	}
+}
+
+static QString
+legacy_terminate(QStringList &apps_stack, const QString &app_id)
+{
+	if (apps_stack.contains(app_id)) {
+		apps_stack.removeOne(app_id);
+		if (!apps_stack.isEmpty())
+			return apps_stack.last();
+	}
+	return QString();
+}
+
+int main(int argc, char *argv[])
+{
+	int n_events = argc > 1 ? atoi(argv[1]) : 100000;
+	int n_apps = argc > 2 ? atoi(argv[2]) : 64;
+	int n_outputs = argc > 3 ? atoi(argv[3]) : 1;
+	std::mt19937 rng(42);
+	QVector<app_event> events;
+	QStringList app_ids, outputs;
+	QElapsedTimer timer;
+	qint64 legacy_ns, stack_ns;
+	int previous = 0;
+
+	if (n_events < 1 || n_apps < 1 || n_outputs < 1) {
+		fprintf(stderr, "usage: %s [events] [applications] [outputs]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (int i = 0; i < n_apps; i++)
+		app_ids << QStringLiteral("org.automotivelinux.app%1").arg(i);
+	for (int i = 0; i < n_outputs; i++)
+		outputs << QStringLiteral("HDMI-A-%1").arg(i + 1);
+
+	std::uniform_int_distribution<int> app(0, n_apps - 1);
+	std::uniform_int_distribution<int> output(0, n_outputs - 1);
+	std::uniform_int_distribution<int> kind(0, 7);
+	events.reserve(n_events);
+	for (int i = 0; i < n_events; i++)
+		events.append({ kind(rng) == 0, app(rng), output(rng) });
+
+	QStringList apps_stack;
+	timer.start();
+	for (const app_event &ev : events) {
+		if (ev.terminate)
+			previous += !legacy_terminate(apps_stack, app_ids[ev.app]).isEmpty();
+		else
+			legacy_activate(apps_stack, app_ids[ev.app]);
+	}
+	legacy_ns = timer.nsecsElapsed();
+
+	/* same stream, all on one output, to check the results agree */
+	AppStack check;
+	for (const app_event &ev : events) {
+		if (ev.terminate)
+			check.remove(app_ids[ev.app]);
+		else
+			check.push(app_ids[ev.app], outputs[0]);
+	}
+	if (check.apps(outputs[0]) != apps_stack) {
+		fprintf(stderr, "AppStack and QStringList disagree on the order\n");
+		return EXIT_FAILURE;
+	}
+
+	AppStack stack;
+	timer.start();
+	for (const app_event &ev : events) {
+		if (ev.terminate) {
+			const QString &app_id = app_ids[ev.app];
+			QString output = stack.outputOf(app_id);
+
+			if (stack.remove(app_id))
+				previous += !stack.top(output).isEmpty();
+		} else {
+			stack.push(app_ids[ev.app], outputs[ev.output]);
+		}
+	}
+	stack_ns = timer.nsecsElapsed();
+
+	printf("%d events, %d applications, %d output(s)\n",
+	       n_events, n_apps, n_outputs);
+	printf("%-24s %10.1f ns/event\n", "QStringList",
+	       (double) legacy_ns / n_events);
+	printf("%-24s %10.1f ns/event\n", "AppStack",
+	       (double) stack_ns / n_events);
+
+	/* keeps the lookups from being optimized away */
+	return previous < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Feeds an event log recorded with HOMESCREEN_EVENT_RECORD back into
+ * HomescreenHandler, without a compositor, and prints the applications it
+ * asks the compositor to activate, in order, followed by the throughput.
+ *
+ * Events are replayed at the speed they were recorded at, or with --max as
+ * fast as the handler takes them, the event loop running once after each
+ * one so that activations are coalesced per event as they would have been.
+ * Activations of the same application closer than the coalescing window
+ * are folded differently at full speed, so the sequence to compare against
+ * the field is the one from a replay at recorded speed.
+ *
+ * Runs on the offscreen platform, with the homescreen's own output as the
+ * only one; applications the log sends to other outputs end up on it.
+ * A replay has no side effects: applaunchd's live events are ignored,
+ * nothing is pre-launched, and the pre-launch statistics go to a
+ * throwaway configuration directory.
+ *
+ * Usage: event-replay [--max] [--quiet] <log>
+ */
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVector>
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eventlog.h"
+#include "homescreenhandler.h"
+#include "outputregistry.h"
+#include "shell.h"
+
+static void
+dispatch(HomescreenHandler *handler, const LoggedEvent &event)
+{
+	switch (event.source) {
+	case LoggedEvent::AppStatus:
+		handler->processAppStatusEvent(event.app_id, event.arg);
+		break;
+	case LoggedEvent::ShellAppState:
+		handler->processShellAppState(AppIdTable::intern(event.app_id), event.code);
+		break;
+	case LoggedEvent::AppOnOutput:
+		handler->processAppOnOutput(AppIdTable::intern(event.app_id), event.arg);
+		break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	// nothing to record, start or remember while replaying
+	qunsetenv("HOMESCREEN_EVENT_RECORD");
+	qunsetenv("HOMESCREEN_PRELAUNCH_BUDGET_MB");
+	QTemporaryDir config_dir;
+	if (!config_dir.isValid()) {
+		fprintf(stderr, "Unable to create a configuration directory: %s\n",
+			qPrintable(config_dir.errorString()));
+		return EXIT_FAILURE;
+	}
+	qputenv("XDG_CONFIG_HOME", QFile::encodeName(config_dir.path()));
+
+	QGuiApplication app(argc, argv);
+	QCommandLineParser parser;
+	QCommandLineOption max_option("max", "Replay as fast as possible.");
+	QCommandLineOption quiet_option("quiet", "Only print the summary.");
+
+	parser.addOption(max_option);
+	parser.addOption(quiet_option);
+	parser.addPositionalArgument("log", "Event log to replay.");
+	parser.addHelpOption();
+	parser.process(app);
+
+	if (parser.positionalArguments().size() != 1)
+		parser.showHelp(EXIT_FAILURE);
+
+	EventReader reader;
+	QVector<LoggedEvent> events;
+	LoggedEvent event;
+
+	if (!reader.open(parser.positionalArguments().at(0))) {
+		fprintf(stderr, "Unable to read %s: %s\n",
+			qPrintable(parser.positionalArguments().at(0)),
+			qPrintable(reader.errorString()));
+		return EXIT_FAILURE;
+	}
+	while (reader.next(event))
+		events.append(event);
+	if (!reader.errorString().isEmpty())
+		fprintf(stderr, "Stopped reading at event %d: %s\n",
+			events.size(), qPrintable(reader.errorString()));
+
+	OutputRegistry outputs(nullptr);
+	Shell shell(std::shared_ptr<struct agl_shell>(), &outputs);
+	HomescreenHandler handler(&shell, &outputs);
+	handler.detachFromLauncher();
+	bool quiet = parser.isSet(quiet_option);
+	int activations = 0;
+	QElapsedTimer timer;
+	qint64 elapsed_ns;
+
+	QObject::connect(&handler, &HomescreenHandler::activationSent,
+			 [&](const QString &app_id, const QString &output) {
+		activations++;
+		if (!quiet)
+			printf("%10.3f ms  activate %s on %s\n",
+			       timer.nsecsElapsed() / 1e6, qPrintable(app_id),
+			       output.isEmpty() ? "default output" : qPrintable(output));
+	});
+
+	timer.start();
+	if (parser.isSet(max_option)) {
+		for (const LoggedEvent &ev : events) {
+			dispatch(&handler, ev);
+			app.processEvents();
+		}
+	} else {
+		QTimer next;
+		int pos = 0;
+
+		next.setSingleShot(true);
+		next.setTimerType(Qt::PreciseTimer);
+		QObject::connect(&next, &QTimer::timeout, [&]() {
+			const qint64 now_us = timer.nsecsElapsed() / 1000;
+
+			while (pos < events.size() && events[pos].time_us <= (uint64_t) now_us)
+				dispatch(&handler, events[pos++]);
+
+			if (pos < events.size())
+				next.start((events[pos].time_us - now_us + 999) / 1000);
+			else
+				QTimer::singleShot(100, &app, &QCoreApplication::quit);
+		});
+		next.start(0);
+		app.exec();
+	}
+	// the last coalesced activations
+	app.processEvents();
+	elapsed_ns = timer.nsecsElapsed();
+
+	const ActivationCoalescer::Stats &stats = handler.activationStats();
+	printf("%d events, %d activations (%llu requested, %llu coalesced)\n",
+	       events.size(), activations,
+	       (unsigned long long) stats.received,
+	       (unsigned long long) stats.coalesced);
+	printf("%.1f ms, %.0f events/s\n", elapsed_ns / 1e6,
+	       events.isEmpty() ? 0.0 : events.size() / (elapsed_ns / 1e9));
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Measures what the homescreen costs while it sits idle: it loads the
+ * shell QML headless (offscreen platform, software Quick backend), shows a
+ * notification and an information message the way an application start
+ * would, waits for them to time out and then counts, over the given
+ * number of seconds:
+ *
+ *  - how often the GUI thread's event dispatcher woke up, and how many of
+ *    those wakeups delivered timer or socket notifier events,
+ *  - scene graph sync and render passes, per window,
+ *  - the CPU time used, scaled to a minute.
+ *
+ * With --max-wakeups it fails when the GUI thread wakes up more often than
+ * that per second, which lets a CI job gate idle-power regressions.
+ *
+ * Usage: idle-bench [--seconds N] [--qml FILE] [--max-wakeups N]
+ */
+
+#include <QAbstractEventDispatcher>
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QQuickWindow>
+#include <QTimer>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+#include <QtQml/qqml.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "applicationlauncher.h"
+#include "backgroundprovider.h"
+#include "iconatlasprovider.h"
+#include "idlestubs.h"
+#include "mastervolume.h"
+#include "statusbarmodel.h"
+#include "statussnapshot.h"
+#include "svgrastercache.h"
+#include "wallclock.h"
+
+/* time for the notification and information timers to run out */
+#define SETTLE_MS	4000
+
+struct idle_counters {
+	quint64 wakeups = 0;
+	quint64 timer_events = 0;
+	quint64 socket_events = 0;
+	quint64 syncs = 0;
+	quint64 renders = 0;
+};
+
+class EventCounter : public QObject
+{
+public:
+	explicit EventCounter(idle_counters *counters) : m_counters(counters) {}
+
+protected:
+	bool eventFilter(QObject *obj, QEvent *event) override
+	{
+		if (event->type() == QEvent::Timer)
+			m_counters->timer_events++;
+		else if (event->type() == QEvent::SockAct)
+			m_counters->socket_events++;
+		return QObject::eventFilter(obj, event);
+	}
+
+private:
+	idle_counters *m_counters;
+};
+
+static double
+cpu_seconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+	setenv("QT_QPA_PLATFORM", "offscreen", 0);
+	setenv("QT_QUICK_BACKEND", "software", 0);
+	setenv("QT_QUICK_CONTROLS_STYLE", "AGL", 1);
+
+	QGuiApplication app(argc, argv);
+
+	QCommandLineParser parser;
+	parser.addHelpOption();
+	parser.addOptions({
+		{ "seconds", "How long to measure for.", "N", "60" },
+		{ "qml", "Shell QML file to load from the resources.", "FILE",
+		  "background_with_panels.qml" },
+		{ "max-wakeups", "Fail above this many wakeups per second.", "N" },
+	});
+	parser.process(app);
+
+	int seconds = parser.value("seconds").toInt();
+	if (seconds < 1)
+		seconds = 1;
+
+	qmlRegisterType<StatusBarModel>("HomeScreen", 1, 0, "StatusBarModel");
+	qmlRegisterType<MasterVolume>("MasterVolume", 1, 0, "MasterVolume");
+
+	SvgRasterCache svg_rasters(app.devicePixelRatio());
+	QQmlEngine engine;
+	engine.addImageProvider(QStringLiteral("background"), new BackgroundImageProvider());
+	engine.addImageProvider(QStringLiteral("icons"), new IconAtlasProvider());
+	if (!svg_rasters.isEmpty())
+		engine.setUrlInterceptor(&svg_rasters);
+
+	IdleHandler handler;
+	ApplicationLauncher launcher;
+	launcher.setCurrent(QStringLiteral("launcher"));
+
+	QQmlContext *context = engine.rootContext();
+	context->setContextProperty("homescreenHandler", &handler);
+	context->setContextProperty("launcher", &launcher);
+	context->setContextProperty("clock", new WallClock(&app));
+	context->setContextProperty("weather", new IdleWeather(&app));
+	context->setContextProperty("bluetooth", new IdleBluetooth(&app));
+	context->setContextProperty("shell", new QObject(&app));
+	context->setContextProperty("snapshot", StatusSnapshot::instance());
+
+	QQmlComponent component(&engine, QUrl("qrc:/" + parser.value("qml")));
+	QObject *root = component.create(context);
+	if (!root) {
+		fprintf(stderr, "%s\n", qPrintable(component.errorString()));
+		return EXIT_FAILURE;
+	}
+
+	idle_counters counters;
+	bool measuring = false;
+
+	QList<QQuickWindow *> windows = root->findChildren<QQuickWindow *>();
+	if (QQuickWindow *window = qobject_cast<QQuickWindow *>(root))
+		windows.prepend(window);
+
+	for (QQuickWindow *window : windows) {
+		QObject::connect(window, &QQuickWindow::afterSynchronizing, &app,
+				 [&]() { if (measuring) counters.syncs++; },
+				 Qt::DirectConnection);
+		QObject::connect(window, &QQuickWindow::afterRendering, &app,
+				 [&]() { if (measuring) counters.renders++; },
+				 Qt::DirectConnection);
+		window->show();
+	}
+
+	EventCounter event_counter(&counters);
+	QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+	QObject::connect(dispatcher, &QAbstractEventDispatcher::awake, &app,
+			 [&]() { if (measuring) counters.wakeups++; });
+
+	emit handler.showNotification(QStringLiteral("navigation"),
+				      QStringLiteral("qrc:/images/Shortcut/navigation.svg"),
+				      QStringLiteral("Navigation started"));
+	emit handler.showInformation(QStringLiteral("Navigation started"));
+
+	double cpu_start = 0;
+
+	QTimer::singleShot(SETTLE_MS, &app, [&]() {
+		counters = idle_counters();
+		app.installEventFilter(&event_counter);
+		cpu_start = cpu_seconds();
+		measuring = true;
+	});
+	QTimer::singleShot(SETTLE_MS + seconds * 1000, &app, [&]() {
+		measuring = false;
+		app.removeEventFilter(&event_counter);
+		app.quit();
+	});
+
+	app.exec();
+
+	double cpu = cpu_seconds() - cpu_start;
+	double wakeups_per_sec = (double) counters.wakeups / seconds;
+
+	printf("idle for %d s, %s, %d window(s)\n", seconds,
+	       qPrintable(parser.value("qml")), windows.size());
+	printf("%-28s %10.2f /s\n", "wakeups", wakeups_per_sec);
+	printf("%-28s %10.2f /s\n", "timer events", (double) counters.timer_events / seconds);
+	printf("%-28s %10.2f /s\n", "socket notifier events", (double) counters.socket_events / seconds);
+	printf("%-28s %10.2f /s\n", "scene graph syncs", (double) counters.syncs / seconds);
+	printf("%-28s %10.2f /s\n", "scene graph renders", (double) counters.renders / seconds);
+	printf("%-28s %10.1f ms/min\n", "cpu time", cpu * 1000.0 * 60 / seconds);
+
+	delete root;
+
+	if (parser.isSet("max-wakeups") &&
+	    wakeups_per_sec > parser.value("max-wakeups").toDouble()) {
+		fprintf(stderr, "idle wakeups above the limit of %s/s\n",
+			qPrintable(parser.value("max-wakeups")));
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IDLESTUBS_H
+#define IDLESTUBS_H
+
+#include <QObject>
+#include <QString>
+
+/*
+ * Stand-ins for the context properties that need a compositor or a
+ * service to talk to. They have the signals the QML connects to and do
+ * nothing on their own, so they add no wakeups of their own.
+ */
+class IdleHandler : public QObject
+{
+	Q_OBJECT
+public:
+	using QObject::QObject;
+
+	Q_INVOKABLE void tapShortcut(QString app_id) { Q_UNUSED(app_id); }
+
+signals:
+	void showNotification(QString application_id, QString icon_path, QString text);
+	void showInformation(QString info);
+};
+
+class IdleWeather : public QObject
+{
+	Q_OBJECT
+public:
+	using QObject::QObject;
+
+signals:
+	void conditionChanged(QString condition);
+	void temperatureChanged(QString temperature);
+};
+
+class IdleBluetooth : public QObject
+{
+	Q_OBJECT
+public:
+	using QObject::QObject;
+
+signals:
+	void powerChanged(bool state);
+};
+
+#endif // IDLESTUBS_H
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Measures what the HMI_* logging costs the caller on the log-heavy path of
+ * HomescreenHandler::activateApp(), for the logger in hmi-debug.{h,cpp}
+ * and for the previous header-only one, which read USE_HMI_DEBUG on every
+ * statement and wrote to stderr synchronously.
+ *
+ * Both are measured with logging disabled (the default level) and with
+ * debug logging enabled. Output goes to /dev/null so that the terminal
+ * doesn't skew the numbers; the enabled runs are done in bursts small enough
+ * for the ring buffer, with the queue flushed outside the timed section.
+ * On a single core the writer thread runs inside the timed sections too, so
+ * the enabled numbers only mean something on a multi-core machine.
+ *
+ * Usage: log-bench [iterations]
+ */
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hmi-debug.h"
+
+#define BURST	64
+
+static const char LEGACY_FLAG[6][20] = {"NONE", "ERROR", "WARNING", "NOTICE", "INFO", "DEBUG"};
+
+/* the previous _HMI_LOG, verbatim apart from the name */
+static void
+legacy_log(enum LOG_LEVEL level, const char* file, const char* func, const int line, const char* prefix, const char* log, ...)
+{
+	char *message;
+	struct timespec tp;
+	uint32_t time;
+	va_list args;
+	const int log_level = (getenv("USE_HMI_DEBUG") == NULL) ? LOG_LEVEL_ERROR : atoi(getenv("USE_HMI_DEBUG"));
+
+	if(log_level < level) {
+		return;
+	}
+
+	va_start(args, log);
+	if (vasprintf(&message, log, args) < 0) {
+		fprintf(stderr, "Warning: message is NULL\n");
+		message = NULL;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &tp);
+	time = (tp.tv_sec * 1000000L) + (tp.tv_nsec / 1000);
+	if (tp.tv_nsec % 1000 >= 500) {
+		time++;
+	}
+
+	fprintf(stderr,  "[%10.3f] [%s %s] [%s, %s(), Line:%d] >>> %s \n", time / 1000.0, prefix, LEGACY_FLAG[level], file, func, line, message);
+
+	va_end(args);
+	free(message);
+}
+
+#define LEGACY_DEBUG(prefix, args,...) legacy_log(LOG_LEVEL_DEBUG, __FILENAME__, __FUNCTION__,__LINE__, prefix, args,##__VA_ARGS__)
+
+/* the statements HomescreenHandler::activateApp() logs for a pending app */
+static void
+activate_app_legacy(const QString &app_id, const QString &output_name, void *output)
+{
+	LEGACY_DEBUG("HomeScreen", "Activating app_id %s by default output %p\n",
+		     app_id.toStdString().c_str(), output);
+	LEGACY_DEBUG("HomeScreen", "For application %s found another "
+		     "output to activate %s\n",
+		     app_id.toStdString().c_str(),
+		     output_name.toStdString().c_str());
+	LEGACY_DEBUG("HomeScreen", "Activating application %s",
+		     app_id.toStdString().c_str());
+}
+
+static void
+activate_app(const QString &app_id, const QString &output_name, void *output)
+{
+	HMI_DEBUG("HomeScreen", "Activating app_id %s by default output %p\n",
+		  app_id.toStdString().c_str(), output);
+	HMI_DEBUG("HomeScreen", "For application %s found another "
+		  "output to activate %s\n",
+		  app_id.toStdString().c_str(),
+		  output_name.toStdString().c_str());
+	HMI_DEBUG("HomeScreen", "Activating application %s",
+		  app_id.toStdString().c_str());
+}
+
+typedef void (*activate_fn)(const QString &, const QString &, void *);
+
+static double
+run(activate_fn fn, int iterations, bool flush)
+{
+	QString app_id = QStringLiteral("navigation");
+	QString output = QStringLiteral("HDMI-A-1");
+	qint64 elapsed = 0;
+	QElapsedTimer timer;
+
+	for (int done = 0; done < iterations; done += BURST) {
+		timer.start();
+		for (int i = 0; i < BURST; i++)
+			fn(app_id, output, &timer);
+		elapsed += timer.nsecsElapsed();
+
+		if (flush)
+			_HMI_LOG_FLUSH();
+	}
+
+	/* per activation, i.e. three log statements */
+	return (double) elapsed / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = argc > 1 ? atoi(argv[1]) : 100000;
+	int devnull = open("/dev/null", O_WRONLY);
+
+	if (iterations < BURST)
+		iterations = BURST;
+	iterations -= iterations % BURST;
+
+	if (devnull < 0) {
+		perror("/dev/null");
+		return EXIT_FAILURE;
+	}
+	fflush(stderr);
+	dup2(devnull, STDERR_FILENO);
+	close(devnull);
+
+	unsetenv("USE_HMI_DEBUG");
+	_HMI_LOG_SET_LEVEL(LOG_LEVEL_ERROR);
+	printf("%-28s %10.1f ns/activation\n", "disabled, legacy",
+	       run(activate_app_legacy, iterations, false));
+	printf("%-28s %10.1f ns/activation\n", "disabled, cached level",
+	       run(activate_app, iterations, false));
+
+	setenv("USE_HMI_DEBUG", "5", 1);
+	_HMI_LOG_SET_LEVEL(LOG_LEVEL_DEBUG);
+	printf("%-28s %10.1f ns/activation\n", "enabled, synchronous",
+	       run(activate_app_legacy, iterations, false));
+	printf("%-28s %10.1f ns/activation\n", "enabled, ring buffer",
+	       run(activate_app, iterations, true));
+
+	return EXIT_SUCCESS;
+}
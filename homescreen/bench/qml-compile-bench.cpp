@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Measures how long the engine takes to compile each of the QML files
+ * shipped in qml.qrc into a QQmlComponent, using a fresh engine per round so
+ * that nothing is served from the engine's type cache.
+ *
+ * Run it as is and with HOMESCREEN_QML_AOT=0 to compare the ahead-of-time
+ * compiled QML against compiling it at runtime.
+ *
+ * Usage: qml-compile-bench [rounds]
+ */
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QMap>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQml/qqml.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "statusbarmodel.h"
+#include "mastervolume.h"
+
+int main(int argc, char *argv[])
+{
+	const char *aot = getenv("HOMESCREEN_QML_AOT");
+	bool use_aot = !(aot && strcmp(aot, "0") == 0);
+	int rounds = argc > 1 ? atoi(argv[1]) : 1;
+	QMap<QString, qint64> total_ns;
+	qint64 all_ns = 0;
+	int errors = 0;
+
+	if (rounds < 1)
+		rounds = 1;
+
+	if (!use_aot)
+		setenv("QML_DISABLE_DISK_CACHE", "1", 1);
+	setenv("QT_QPA_PLATFORM", "offscreen", 0);
+	setenv("QT_QUICK_CONTROLS_STYLE", "AGL", 1);
+
+	QGuiApplication app(argc, argv);
+
+	qmlRegisterType<StatusBarModel>("HomeScreen", 1, 0, "StatusBarModel");
+	qmlRegisterType<MasterVolume>("MasterVolume", 1, 0, "MasterVolume");
+
+	QStringList files;
+	QDirIterator it(QStringLiteral(":/"), { QStringLiteral("*.qml") }, QDir::Files);
+	while (it.hasNext()) {
+		it.next();
+		files << it.fileName();
+	}
+	files.sort();
+
+	// files are compiled in name order, so a file that uses others
+	// (background_with_panels.qml) doesn't pay for those already compiled;
+	// the total is what the homescreen pays at start-up
+	for (int round = 0; round < rounds; round++) {
+		QQmlEngine engine;
+
+		for (const QString &file : files) {
+			QElapsedTimer timer;
+
+			timer.start();
+			QQmlComponent comp(&engine, QUrl(QStringLiteral("qrc:/") + file));
+			qint64 ns = timer.nsecsElapsed();
+
+			if (comp.isError() && round == 0) {
+				fprintf(stderr, "%s: %s\n", qPrintable(file),
+					qPrintable(comp.errorString()));
+				errors++;
+			}
+
+			total_ns[file] += ns;
+			all_ns += ns;
+		}
+	}
+
+	printf("QML compile time, %s, mean of %d round(s):\n",
+	       use_aot ? "ahead-of-time compiled" : "compiled at runtime", rounds);
+	for (auto it = total_ns.constBegin(); it != total_ns.constEnd(); ++it)
+		printf("  %-32s %9.3f ms\n", qPrintable(it.key()),
+		       it.value() / 1e6 / rounds);
+	printf("  %-32s %9.3f ms\n", "total", all_ns / 1e6 / rounds);
+	if (errors)
+		printf("  %d file(s) failed to compile, see above\n", errors);
+
+	return EXIT_SUCCESS;
+}
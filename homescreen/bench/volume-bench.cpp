@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Counts the writes a drag of the master volume slider sends to the
+ * vehicle-signal broker, writing every step as MasterVolume used to and
+ * through CoalescedWriter, against a broker that echoes each write back to
+ * its subscribers after a given latency.
+ *
+ * A gesture moves the slider from 0 to 100, one step per frame, then lets
+ * go. It also counts the echoes that would have moved the slider back
+ * (applied while the user had already moved on), and checks that the
+ * broker ends up with the value the slider was left at.
+ *
+ * Usage: volume-bench [broker latency ms...]
+ */
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "coalescedwriter.h"
+
+#define STEPS		100
+#define STEP_MS		16
+#define SETTLE_MS	1000
+
+/* a broker echoing each write to its subscribers */
+class Broker : public QObject
+{
+public:
+	Broker(int latency_ms) : m_latency_ms(latency_ms) {}
+
+	void set(const QString &value)
+	{
+		writes++;
+		QTimer::singleShot(m_latency_ms, this, [this, value]() {
+			this->value = value;
+			if (notify)
+				notify(value);
+		});
+	}
+
+	std::function<void(const QString &)> notify;
+	QString value;
+	int writes = 0;
+
+private:
+	int m_latency_ms;
+};
+
+struct result {
+	int writes;
+	int fights;
+	bool settled;
+};
+
+static void
+run_for(int ms)
+{
+	QEventLoop loop;
+
+	QTimer::singleShot(ms, Qt::PreciseTimer, &loop, &QEventLoop::quit);
+	loop.exec();
+}
+
+static result
+drag(int latency_ms, bool coalesced)
+{
+	Broker broker(latency_ms);
+	CoalescedWriter writer([&broker](const QString &value) { broker.set(value); });
+	int slider = 0;
+	// notifications that would move the slider away from where it is
+	int fights = 0;
+
+	broker.notify = [&](const QString &value) {
+		if (coalesced && writer.acknowledge(value))
+			return;
+		if (value.toInt() != slider)
+			fights++;
+	};
+
+	for (slider = 1; slider <= STEPS; slider++) {
+		if (coalesced)
+			writer.write(QString::number(slider));
+		else
+			broker.set(QString::number(slider));
+		run_for(STEP_MS);
+	}
+	slider = STEPS;
+	run_for(SETTLE_MS);
+
+	return { broker.writes, fights, broker.value == QString::number(STEPS) };
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QList<int> latencies;
+	bool ok = true;
+
+	for (int i = 1; i < argc; i++)
+		latencies << atoi(argv[i]);
+	if (latencies.isEmpty())
+		latencies << 2 << 20 << 100;
+
+	printf("%d steps, one every %d ms\n", STEPS, STEP_MS);
+	printf("%-12s %-12s %8s %8s %8s\n", "latency", "writer", "writes", "fights", "settled");
+
+	for (int latency : latencies) {
+		for (bool coalesced : { false, true }) {
+			result r = drag(latency, coalesced);
+
+			printf("%-12s %-12s %8d %8d %8s\n",
+			       qPrintable(QStringLiteral("%1 ms").arg(latency)),
+			       coalesced ? "coalesced" : "every step",
+			       r.writes, r.fights, r.settled ? "yes" : "no");
+			ok = ok && r.settled;
+		}
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -51,13 +51,13 @@ Image {
             Layout.fillHeight: true
             Layout.preferredHeight: 107
             Image {
-                source: './images/MediaPlayer/AGL_MediaPlayer_BackArrow.png'
+                source: 'image://icons/MediaPlayer/AGL_MediaPlayer_BackArrow.png'
             }
             Image {
-                source: './images/MediaPlayer/AGL_MediaPlayer_Player_Pause.png'
+                source: 'image://icons/MediaPlayer/AGL_MediaPlayer_Player_Pause.png'
             }
             Image {
-                source: './images/MediaPlayer/AGL_MediaPlayer_ForwardArrow.png'
+                source: 'image://icons/MediaPlayer/AGL_MediaPlayer_ForwardArrow.png'
             }
 
             ProgressBar {
@@ -71,10 +71,10 @@ Image {
                 font.pixelSize: 20
             }
             Image {
-                source: './images/MediaPlayer/AGL_MediaPlayer_Shuffle_Active.png'
+                source: 'image://icons/MediaPlayer/AGL_MediaPlayer_Shuffle_Active.png'
             }
             Image {
-                source: './images/MediaPlayer/AGL_MediaPlayer_Shuffle_Active.png'
+                source: 'image://icons/MediaPlayer/AGL_MediaPlayer_Shuffle_Active.png'
             }
             ProgressBar {
                 Layout.fillWidth: true
@@ -25,33 +25,36 @@ Item {
     //width: 295
     //height: 216
 
-    property date now: new Date
-    Timer {
-        interval: 100; running: true; repeat: true;
-        onTriggered: root.now = new Date
+    function conditionIcon(condition) {
+        var icon = ''
+
+        if (condition.indexOf("clouds") !== -1) {
+            icon = "WeatherIcons_Cloudy-01.png"
+        } else if (condition.indexOf("thunderstorm") !== -1) {
+            icon = "WeatherIcons_Thunderstorm-01.png"
+        } else if (condition.indexOf("snow") !== -1) {
+            icon = "WeatherIcons_Snow-01.png"
+        } else if (condition.indexOf("rain") !== -1) {
+            icon = "WeatherIcons_Rain-01.png"
+        }
+
+        return icon ? 'image://icons/Weather/' + icon : ''
+    }
+
+    function temperatureText(temperature) {
+        return temperature.split(".")[0] + '°F'
     }
 
+    // the live values replace the ones from the last boot
     Connections {
         target: weather
 
         onConditionChanged: {
-            var icon = ''
-
-            if (condition.indexOf("clouds") !== -1) {
-                icon = "WeatherIcons_Cloudy-01.png"
-            } else if (condition.indexOf("thunderstorm") !== -1) {
-                icon = "WeatherIcons_Thunderstorm-01.png"
-            } else if (condition.indexOf("snow") !== -1) {
-                icon = "WeatherIcons_Snow-01.png"
-            } else if (condition.indexOf("rain") !== -1) {
-                icon = "WeatherIcons_Rain-01.png"
-            }
-
-            condition_item.source = icon ? './images/Weather/' + icon : ''
+            condition_item.source = root.conditionIcon(condition)
         }
 
         onTemperatureChanged: {
-            temperature_item.text = temperature.split(".")[0] + '°F'
+            temperature_item.text = root.temperatureText(temperature)
         }
     }
 
@@ -69,7 +72,7 @@ Item {
                 Text {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
-                    text: Qt.formatDate(now, 'dddd').toUpperCase()
+                    text: clock.day
                     font.family: 'Roboto'
                     font.pixelSize: 13
                     color: 'white'
@@ -86,7 +89,7 @@ Item {
                 Text {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
-                    text: Qt.formatTime(now, 'h:mm ap').toUpperCase()
+                    text: clock.time
                     font.family: 'Roboto'
                     font.pixelSize: 40
                     color: 'white'
@@ -99,11 +102,12 @@ Item {
                     Layout.preferredHeight: 20
                     Image {
                         id: condition_item
-                        source: './images/Weather/WeatherIcons_Rain-01.png'
+                        source: snapshot.condition ? root.conditionIcon(snapshot.condition)
+                                                : 'image://icons/Weather/WeatherIcons_Rain-01.png'
                     }
                     Text {
                         id: temperature_item
-                        text: '64°F'
+                        text: snapshot.temperature ? root.temperatureText(snapshot.temperature) : '64°F'
                         color: 'white'
                         font.family: 'Helvetica'
                         font.pixelSize: 32
@@ -118,29 +122,24 @@ Item {
             Layout.preferredWidth: 76
             spacing: -10
 
-            Image {
-                id: bt_icon
-                Layout.preferredWidth: 77
-                Layout.preferredHeight: 73
-                source: connStatus ? './images/Status/HMI_Status_Bluetooth_On-01.png' : './images/Status/HMI_Status_Bluetooth_Inactive-01.png'
-                fillMode: Image.PreserveAspectFit
-                property string deviceName: "none"
-                property bool connStatus: false
-                Connections {
-                    target: bluetooth
-
-                    onPowerChanged: {
-                            bt_icon.connStatus = state
-                    }
-                }
-            }
             Repeater {
                 model: StatusBarModel { objectName: "statusBar" }
-                delegate: Image {
+                delegate: Item {
                     Layout.preferredWidth: 77
                     Layout.preferredHeight: 73
-                    source: model.modelData
-                    fillMode: Image.PreserveAspectFit
+                    Image {
+                        anchors.fill: parent
+                        source: model.icon
+                        fillMode: Image.PreserveAspectFit
+                    }
+                    // indicators without artwork, e.g. the battery level
+                    Text {
+                        anchors.centerIn: parent
+                        text: model.text
+                        color: 'white'
+                        font.family: 'Helvetica'
+                        font.pixelSize: 24
+                    }
                 }
             }
         }
@@ -10,6 +10,7 @@ Window {
 
     Image {
         anchors.fill: parent
-        source: './images/bg_scooterson_vertical.png'
+        sourceSize: Qt.size(width, height)
+        source: 'image://background/bg_scooterson_vertical'
     }
 }
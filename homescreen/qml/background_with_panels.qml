@@ -22,7 +22,7 @@ Window {
              id:notificationTimer
              interval: 3000
              running: false
-             repeat: true
+             repeat: false
              onTriggered: notificationItem.visible = false
          }
 
@@ -104,7 +104,8 @@ Window {
              height: Screen.height - (2 * 216)
          Image {
              anchors.fill: parent
-             source: './images/bg_scooterson_vertical.png'
+             sourceSize: Qt.size(width, height)
+             source: 'image://background/bg_scooterson_vertical'
          }
 
         }
@@ -121,7 +122,7 @@ Window {
              id:informationTimer
              interval: 3000
              running: false
-             repeat: true
+             repeat: false
              onTriggered: {
                  bottomInformation.visible = false
              }
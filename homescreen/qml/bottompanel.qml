@@ -16,7 +16,7 @@ Window {
         id:informationTimer
         interval: 3000
         running: false
-        repeat: true
+        repeat: false
         onTriggered: {
             bottomInformation.visible = false
         }
@@ -16,7 +16,7 @@ Window {
         id:notificationTimer
         interval: 3000
         running: false
-        repeat: true
+        repeat: false
         onTriggered: notificationItem.visible = false
     }
 
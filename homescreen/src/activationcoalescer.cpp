@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "activationcoalescer.h"
+#include "hmi-debug.h"
+
+// about a frame at 60Hz
+#define REPEAT_WINDOW_MS	16
+
+ActivationCoalescer::ActivationCoalescer(OutputRegistry *outputs, ActivateFn activate,
+					 QObject *parent) :
+	QObject(parent),
+	m_outputs(outputs),
+	m_activate(std::move(activate))
+{
+	m_flush.setSingleShot(true);
+	m_flush.setInterval(0);
+	connect(&m_flush, &QTimer::timeout, this, &ActivationCoalescer::flush);
+	m_clock.start();
+}
+
+void ActivationCoalescer::request(const QString &app_id)
+{
+	m_stats.received++;
+
+	if (m_requests.removeOne(app_id))
+		m_stats.coalesced++;
+	m_requests.append(app_id);
+
+	if (!m_flush.isActive())
+		m_flush.start();
+}
+
+void ActivationCoalescer::flush()
+{
+	QList<QPair<QString, QString>> winners;
+	QHash<QString, bool> taken;
+	qint64 now = m_clock.elapsed();
+
+	m_flush.stop();
+
+	// the most recent request for each output wins
+	for (int i = m_requests.size() - 1; i >= 0; i--) {
+		const QString &app_id = m_requests.at(i);
+		OutputRegistry::Output output = m_outputs->pendingOutput(app_id);
+
+		if (!output.isValid())
+			output = m_outputs->defaultOutput();
+
+		if (taken.contains(output.name)) {
+			m_stats.coalesced++;
+			continue;
+		}
+		taken.insert(output.name, true);
+
+		auto recent = m_recent.constFind(output.name);
+		if (recent != m_recent.constEnd() && recent->app_id == app_id &&
+		    now - recent->when_ms < REPEAT_WINDOW_MS) {
+			m_stats.coalesced++;
+			continue;
+		}
+
+		winners.prepend({ app_id, output.name });
+	}
+	m_requests.clear();
+
+	for (const auto &winner : winners) {
+		m_recent.insert(winner.second, { winner.first, now });
+		m_stats.emitted++;
+		m_activate(winner.first);
+	}
+
+	HMI_DEBUG("HomeScreen", "activations: %llu received, %llu coalesced, %llu emitted",
+		  (unsigned long long) m_stats.received,
+		  (unsigned long long) m_stats.coalesced,
+		  (unsigned long long) m_stats.emitted);
+}
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ACTIVATIONCOALESCER_H
+#define ACTIVATIONCOALESCER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <functional>
+
+#include "outputregistry.h"
+
+/*
+ * Collects the activation requests made during one turn of the event loop
+ * (agl_shell app state events, applaunchd status events, shortcuts) and
+ * then issues at most one activation per output: the most recent request
+ * for that output wins. A request for the application that was activated
+ * on the same output less than a frame ago is dropped too, which catches
+ * the compositor and applaunchd both reporting the same start.
+ */
+class ActivationCoalescer : public QObject
+{
+	Q_OBJECT
+public:
+	struct Stats {
+		quint64 received = 0;
+		quint64 coalesced = 0;
+		quint64 emitted = 0;
+	};
+
+	using ActivateFn = std::function<void(const QString &app_id)>;
+
+	ActivationCoalescer(OutputRegistry *outputs, ActivateFn activate,
+			    QObject *parent = nullptr);
+
+	void request(const QString &app_id);
+	/* issues the pending activations right away */
+	void flush();
+
+	const Stats &stats() const { return m_stats; }
+
+private:
+	struct Recent {
+		QString app_id;
+		qint64 when_ms;
+	};
+
+	OutputRegistry *m_outputs;
+	ActivateFn m_activate;
+	// requested applications, least recent first, each once
+	QStringList m_requests;
+	QTimer m_flush;
+	QElapsedTimer m_clock;
+	// last activation issued, per output name
+	QHash<QString, Recent> m_recent;
+	Stats m_stats;
+};
+
+#endif // ACTIVATIONCOALESCER_H
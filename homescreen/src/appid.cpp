@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QByteArray>
+#include <QHash>
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string.h>
+
+#include "appid.h"
+#include "agl-shell-client-protocol.h"
+
+namespace {
+
+struct Entry {
+	QString name;
+	QByteArray utf8;
+};
+
+/*
+ * Ids are interned from the agl_shell dispatch thread as well as from the
+ * GUI thread. Entries are never removed, and a deque doesn't move them as
+ * it grows, so the UTF-8 pointers handed out stay valid.
+ */
+struct Table {
+	std::shared_mutex lock;
+	std::deque<Entry> entries;
+	QHash<QByteArray, AppId> by_utf8;
+	QHash<QString, AppId> by_name;
+};
+
+Table &
+table()
+{
+	// never destroyed, ids may be looked up from static destructors
+	static Table *t = new Table;
+	return *t;
+}
+
+AppId
+insert(Table &t, const QString &name, const QByteArray &utf8)
+{
+	std::unique_lock<std::shared_mutex> guard(t.lock);
+
+	// someone may have got there first
+	AppId app = t.by_utf8.value(utf8);
+	if (app)
+		return app;
+
+	t.entries.push_back({ name, utf8 });
+	app = t.entries.size();
+	t.by_utf8.insert(utf8, app);
+	t.by_name.insert(name, app);
+	return app;
+}
+
+} // namespace
+
+AppId AppIdTable::intern(const char *utf8)
+{
+	Table &t = table();
+
+	if (!utf8 || !*utf8)
+		return 0;
+
+	{
+		std::shared_lock<std::shared_mutex> guard(t.lock);
+		AppId app = t.by_utf8.value(QByteArray::fromRawData(utf8, strlen(utf8)));
+		if (app)
+			return app;
+	}
+
+	QByteArray copy(utf8);
+	return insert(t, QString::fromUtf8(copy), copy);
+}
+
+AppId AppIdTable::intern(const QString &app_id)
+{
+	Table &t = table();
+
+	if (app_id.isEmpty())
+		return 0;
+
+	{
+		std::shared_lock<std::shared_mutex> guard(t.lock);
+		AppId app = t.by_name.value(app_id);
+		if (app)
+			return app;
+	}
+
+	return insert(t, app_id, app_id.toUtf8());
+}
+
+QString AppIdTable::name(AppId app)
+{
+	Table &t = table();
+	std::shared_lock<std::shared_mutex> guard(t.lock);
+
+	if (app == 0 || app > t.entries.size())
+		return QString();
+	return t.entries[app - 1].name;
+}
+
+const char *AppIdTable::utf8(AppId app)
+{
+	Table &t = table();
+	std::shared_lock<std::shared_mutex> guard(t.lock);
+
+	if (app == 0 || app > t.entries.size())
+		return "";
+	return t.entries[app - 1].utf8.constData();
+}
+
+AppEvent appEventFromStatus(const QString &status)
+{
+	if (status == QLatin1String("started"))
+		return AppEvent::Started;
+	if (status == QLatin1String("terminated"))
+		return AppEvent::Terminated;
+	if (status == QLatin1String("deactivated"))
+		return AppEvent::Deactivated;
+	return AppEvent::None;
+}
+
+AppEvent appEventFromShellState(uint32_t state)
+{
+	switch (state) {
+	case AGL_SHELL_APP_STATE_STARTED:
+		return AppEvent::Started;
+	case AGL_SHELL_APP_STATE_TERMINATED:
+		return AppEvent::Terminated;
+	case AGL_SHELL_APP_STATE_ACTIVATED:
+		return AppEvent::Activated;
+	case AGL_SHELL_APP_STATE_DEACTIVATED:
+		return AppEvent::Deactivated;
+	default:
+		return AppEvent::None;
+	}
+}
+
+const char *appEventName(AppEvent event)
+{
+	switch (event) {
+	case AppEvent::Started:
+		return "started";
+	case AppEvent::Terminated:
+		return "terminated";
+	case AppEvent::Activated:
+		return "activated";
+	case AppEvent::Deactivated:
+		return "deactivated";
+	default:
+		return "none";
+	}
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef APPID_H
+#define APPID_H
+
+#include <QString>
+
+#include <stdint.h>
+
+/*
+ * Small integer handle for an application id, 0 meaning none. Every
+ * app_id the homescreen hears about is interned once in AppIdTable and
+ * keeps its handle, its QString and its UTF-8 form for the lifetime of the
+ * process, so that the event path compares integers and hands out shared
+ * copies instead of converting strings back and forth.
+ */
+typedef uint32_t AppId;
+
+class AppIdTable
+{
+public:
+	/* any thread; only allocates the first time an id is seen */
+	static AppId intern(const char *utf8);
+	static AppId intern(const QString &app_id);
+
+	static QString name(AppId app);
+	/* valid for the lifetime of the process, "" for 0 */
+	static const char *utf8(AppId app);
+};
+
+/*
+ * What happened to an application, whether applaunchd told us (as a status
+ * string) or the compositor did (as an agl_shell app_state).
+ */
+enum class AppEvent : uint8_t {
+	None,
+	Started,
+	Terminated,
+	Activated,
+	Deactivated,
+};
+
+AppEvent appEventFromStatus(const QString &status);
+AppEvent appEventFromShellState(uint32_t state);
+const char *appEventName(AppEvent event);
+
+#endif // APPID_H
@@ -25,6 +25,7 @@
 ApplicationLauncher::ApplicationLauncher(QObject *parent)
     : QObject(parent)
     , m_launching(false)
+    , m_current_app(0)
     , m_timeout(new QTimer(this))
 {
     m_timeout->setInterval(3000);
@@ -64,5 +65,14 @@ void ApplicationLauncher::setCurrent(const QString &current)
 {
     if (m_current == current) return;
     m_current = current;
+    m_current_app = AppIdTable::intern(current);
     emit currentChanged(current);
 }
+
+void ApplicationLauncher::setCurrentApp(AppId app)
+{
+    if (m_current_app == app) return;
+    m_current_app = app;
+    m_current = AppIdTable::name(app);
+    emit currentChanged(m_current);
+}
@@ -21,6 +21,8 @@
 
 #include <QtCore/QObject>
 
+#include "appid.h"
+
 class QTimer;
 
 class ApplicationLauncher : public QObject
@@ -33,6 +35,8 @@ public:
 
     bool isLaunching() const;
     QString current() const;
+    // same as setCurrent(), comparing handles rather than strings
+    void setCurrentApp(AppId app);
 
 signals:
     void newAppRequestsToBeVisible(int pid);
@@ -48,6 +52,7 @@ private:
 private:
     bool m_launching;
     QString m_current;
+    AppId m_current_app;
     QTimer *m_timeout;
 };
 
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "appstack.h"
+
+void AppStack::push(const QString &app_id, const QString &output)
+{
+	auto it = m_index.find(app_id);
+
+	if (it == m_index.end()) {
+		Stack &stack = m_stacks[output];
+		m_index.insert(app_id, { output, stack.insert(stack.end(), app_id) });
+		return;
+	}
+
+	Entry &entry = it.value();
+	if (entry.output == output) {
+		Stack &stack = m_stacks[output];
+		// relinks the node, the iterator stays valid
+		stack.splice(stack.end(), stack, entry.pos);
+		return;
+	}
+
+	Stack &stack = m_stacks[output];
+	auto old_stack = m_stacks.find(entry.output);
+
+	stack.splice(stack.end(), old_stack.value(), entry.pos);
+	if (old_stack.value().empty())
+		m_stacks.erase(old_stack);
+	entry.output = output;
+}
+
+bool AppStack::remove(const QString &app_id)
+{
+	auto it = m_index.find(app_id);
+
+	if (it == m_index.end())
+		return false;
+
+	auto stack = m_stacks.find(it->output);
+	stack.value().erase(it->pos);
+	if (stack.value().empty())
+		m_stacks.erase(stack);
+
+	m_index.erase(it);
+	return true;
+}
+
+QString AppStack::outputOf(const QString &app_id) const
+{
+	auto it = m_index.constFind(app_id);
+
+	return it == m_index.constEnd() ? QString() : it->output;
+}
+
+QString AppStack::top(const QString &output) const
+{
+	auto it = m_stacks.constFind(output);
+
+	return it == m_stacks.constEnd() ? QString() : it->back();
+}
+
+bool AppStack::isEmpty(const QString &output) const
+{
+	return !m_stacks.contains(output);
+}
+
+QStringList AppStack::apps(const QString &output) const
+{
+	auto it = m_stacks.constFind(output);
+	QStringList list;
+
+	if (it != m_stacks.constEnd())
+		for (const QString &app_id : *it)
+			list << app_id;
+
+	return list;
+}
+
+QStringList AppStack::outputs() const
+{
+	return m_stacks.keys();
+}
+
+void AppStack::clear()
+{
+	m_index.clear();
+	m_stacks.clear();
+}
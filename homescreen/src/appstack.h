@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef APPSTACK_H
+#define APPSTACK_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <list>
+
+/*
+ * Most-recently-activated order of the running applications, kept
+ * separately for each output. An application is on one output at a time;
+ * pushing it on another output moves it there.
+ *
+ * Every stack is a linked list with the most recent application at the
+ * back, and a hash maps each application to its output and list node, so
+ * promoting, removing and looking up an application are all O(1).
+ */
+class AppStack
+{
+public:
+	AppStack() = default;
+	AppStack(const AppStack &) = delete;
+	AppStack &operator=(const AppStack &) = delete;
+
+	/* makes app_id the most recent application of output */
+	void push(const QString &app_id, const QString &output);
+	bool remove(const QString &app_id);
+
+	bool contains(const QString &app_id) const { return m_index.contains(app_id); }
+	QString outputOf(const QString &app_id) const;
+
+	/* most recent application of output, or an empty string */
+	QString top(const QString &output) const;
+	bool isEmpty(const QString &output) const;
+	int size() const { return m_index.size(); }
+
+	/* applications of output, least recent first */
+	QStringList apps(const QString &output) const;
+	QStringList outputs() const;
+
+	void clear();
+
+private:
+	using Stack = std::list<QString>;
+
+	struct Entry {
+		QString output;
+		Stack::iterator pos;
+	};
+
+	QHash<QString, Stack> m_stacks;
+	QHash<QString, Entry> m_index;
+};
+
+#endif // APPSTACK_H
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include "backgroundprovider.h"
+#include "rawimage.h"
+
+#ifndef HOMESCREEN_BACKGROUND_DIR
+#define HOMESCREEN_BACKGROUND_DIR "/usr/share/homescreen/backgrounds"
+#endif
+
+static bool
+is_portrait(const QSize &size)
+{
+	return size.height() > size.width();
+}
+
+static void
+unmap_raw_image(void *info)
+{
+	// closing the file also unmaps it
+	delete static_cast<QFile *>(info);
+}
+
+static QImage
+map_raw_image(const QString &path)
+{
+	QFile *file = new QFile(path);
+	const struct raw_image_header *header;
+	qint64 file_size;
+	uchar *data;
+
+	if (!file->open(QIODevice::ReadOnly)) {
+		qWarning() << "Unable to open" << path << file->errorString();
+		delete file;
+		return QImage();
+	}
+
+	file_size = file->size();
+	data = file_size >= (qint64) sizeof(*header) ? file->map(0, file_size) : nullptr;
+	if (!data) {
+		qWarning() << "Unable to map" << path;
+		delete file;
+		return QImage();
+	}
+
+	header = reinterpret_cast<const struct raw_image_header *>(data);
+	if (header->magic != RAW_IMAGE_MAGIC || header->version != RAW_IMAGE_VERSION ||
+	    (header->format != QImage::Format_RGB32 &&
+	     header->format != QImage::Format_ARGB32_Premultiplied) ||
+	    header->stride < header->width * 4 || header->data_offset % 4 ||
+	    header->data_offset + (qint64) header->stride * header->height > file_size) {
+		qWarning() << "Invalid raw image" << path;
+		delete file;
+		return QImage();
+	}
+
+	// read-only mapping: the const constructor makes QImage copy on write
+	return QImage(static_cast<const uchar *>(data) + header->data_offset,
+		      header->width, header->height,
+		      header->stride, static_cast<QImage::Format>(header->format),
+		      unmap_raw_image, file);
+}
+
+BackgroundImageProvider::BackgroundImageProvider() :
+	QQuickImageProvider(QQuickImageProvider::Image)
+{
+	const char *dir = getenv("HOMESCREEN_BACKGROUND_DIR");
+
+	m_dir = QString::fromLocal8Bit(dir ? dir : HOMESCREEN_BACKGROUND_DIR);
+
+	// variants are named <name>-<width>x<height>.raw
+	const QStringList files = QDir(m_dir).entryList({ QStringLiteral("*.raw") }, QDir::Files);
+	for (const QString &file : files) {
+		QString base = file.chopped(4);
+		int sep = base.lastIndexOf(QLatin1Char('-'));
+		QStringList dims = base.mid(sep + 1).split(QLatin1Char('x'));
+
+		if (sep <= 0 || dims.size() != 2)
+			continue;
+
+		QSize size(dims[0].toInt(), dims[1].toInt());
+		if (!size.isEmpty())
+			m_variants[base.left(sep)].append(size);
+	}
+}
+
+/*
+ * Prefers the variant with the exact size, then the closest one in size with
+ * the same orientation, which the item then scales on the GPU.
+ */
+QString BackgroundImageProvider::findVariant(const QString &id, const QSize &target) const
+{
+	const QList<QSize> sizes = m_variants.value(id);
+	qint64 target_area = (qint64) target.width() * target.height();
+	qint64 best_delta = -1;
+	QSize best;
+
+	for (const QSize &size : sizes) {
+		qint64 delta;
+
+		if (is_portrait(size) != is_portrait(target))
+			continue;
+
+		delta = qAbs((qint64) size.width() * size.height() - target_area);
+		if (best_delta < 0 || delta < best_delta) {
+			best = size;
+			best_delta = delta;
+		}
+
+		if (size == target)
+			break;
+	}
+
+	if (best_delta < 0)
+		return QString();
+
+	return QStringLiteral("%1/%2-%3x%4.raw").arg(m_dir, id)
+		.arg(best.width()).arg(best.height());
+}
+
+QImage BackgroundImageProvider::requestImage(const QString &id, QSize *size,
+					     const QSize &requestedSize)
+{
+	QSize target = requestedSize;
+	QImage image;
+
+	if (target.width() <= 0 || target.height() <= 0) {
+		QScreen *screen = qApp->primaryScreen();
+		if (screen)
+			target = screen->size() * screen->devicePixelRatio();
+	}
+
+	QString variant = findVariant(id, target);
+	if (!variant.isEmpty())
+		image = map_raw_image(variant);
+
+	if (image.isNull()) {
+		qDebug() << "No pre-scaled" << target << "background for" << id
+			 << "- decoding the PNG";
+		image.load(QStringLiteral(":/images/%1.png").arg(id));
+		if (image.isNull())
+			qWarning() << "Unable to load background" << id;
+	}
+
+	if (size)
+		*size = image.size();
+
+	return image;
+}
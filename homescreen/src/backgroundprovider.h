@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BACKGROUNDPROVIDER_H
+#define BACKGROUNDPROVIDER_H
+
+#include <QHash>
+#include <QList>
+#include <QQuickImageProvider>
+#include <QSize>
+#include <QString>
+
+/*
+ * Serves the backgrounds as image://background/<name>.
+ *
+ * The backgrounds are pre-scaled at build time (tools/bgconvert) to the
+ * sizes they are shown at, and the variant that matches the requested size,
+ * or failing that the size and orientation of the screen, is mapped straight
+ * into a QImage without decoding it. When no variant has the right
+ * orientation the PNG bundled in the resources is decoded instead.
+ */
+class BackgroundImageProvider : public QQuickImageProvider
+{
+public:
+	BackgroundImageProvider();
+
+	QImage requestImage(const QString &id, QSize *size,
+			    const QSize &requestedSize) override;
+
+private:
+	QString findVariant(const QString &id, const QSize &target) const;
+
+	QString m_dir;
+	QHash<QString, QList<QSize>> m_variants;
+};
+
+#endif // BACKGROUNDPROVIDER_H
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+/*
+ * Fixed-size, lock-free multi-producer/multi-consumer queue (D. Vyukov's
+ * bounded MPMC queue). Pushing to a full queue fails instead of blocking,
+ * and neither side ever allocates.
+ *
+ * push_with()/pop_with() hand the callback a reference to the slot itself,
+ * which avoids copying large elements in and out.
+ */
+template <typename T, size_t Capacity>
+class BoundedQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+		      "Capacity must be a power of two");
+
+public:
+	BoundedQueue()
+	{
+		for (size_t i = 0; i < Capacity; i++)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	BoundedQueue(const BoundedQueue &) = delete;
+	BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+	template <typename Fn>
+	bool push_with(Fn &&fill)
+	{
+		size_t pos = m_enqueue.load(std::memory_order_relaxed);
+		Cell *cell;
+
+		for (;;) {
+			cell = &m_cells[pos & (Capacity - 1)];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) pos;
+
+			if (diff == 0) {
+				if (m_enqueue.compare_exchange_weak(pos, pos + 1,
+								    std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;	/* full */
+			} else {
+				pos = m_enqueue.load(std::memory_order_relaxed);
+			}
+		}
+
+		fill(cell->data);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool push(const T &value)
+	{
+		return push_with([&value](T &slot) { slot = value; });
+	}
+
+	template <typename Fn>
+	bool pop_with(Fn &&consume)
+	{
+		size_t pos = m_dequeue.load(std::memory_order_relaxed);
+		Cell *cell;
+
+		for (;;) {
+			cell = &m_cells[pos & (Capacity - 1)];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) (pos + 1);
+
+			if (diff == 0) {
+				if (m_dequeue.compare_exchange_weak(pos, pos + 1,
+								    std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;	/* empty */
+			} else {
+				pos = m_dequeue.load(std::memory_order_relaxed);
+			}
+		}
+
+		consume(cell->data);
+		cell->sequence.store(pos + Capacity, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T &value)
+	{
+		return pop_with([&value](T &slot) { value = static_cast<T &&>(slot); });
+	}
+
+	bool empty() const
+	{
+		return m_enqueue.load(std::memory_order_acquire) ==
+			m_dequeue.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	alignas(64) Cell m_cells[Capacity];
+	alignas(64) std::atomic<size_t> m_enqueue{0};
+	alignas(64) std::atomic<size_t> m_dequeue{0};
+};
+
+#endif // BOUNDEDQUEUE_H
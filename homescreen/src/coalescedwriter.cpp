@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "coalescedwriter.h"
+
+// a broker round trip on the target is well below this
+#define MIN_INTERVAL_MS		50
+#define ACK_TIMEOUT_MS		500
+// late echoes older than this many timeouts won't come any more
+#define MAX_LATE		4
+
+CoalescedWriter::CoalescedWriter(WriteFn write, QObject *parent) :
+	QObject(parent),
+	m_write(std::move(write))
+{
+	m_interval.setSingleShot(true);
+	m_interval.setInterval(MIN_INTERVAL_MS);
+	connect(&m_interval, &QTimer::timeout, this, [this]() {
+		if (m_echoed)
+			complete();
+	});
+
+	m_timeout.setSingleShot(true);
+	m_timeout.setInterval(ACK_TIMEOUT_MS);
+	connect(&m_timeout, &QTimer::timeout, this, &CoalescedWriter::timedOut);
+}
+
+void CoalescedWriter::write(const QString &value)
+{
+	m_stats.requested++;
+
+	if (m_in_flight) {
+		m_pending = value;
+		m_has_pending = true;
+		return;
+	}
+
+	// nothing to send if the last write already asked for it
+	if (m_has_sent && m_sent == value)
+		return;
+
+	send(value);
+}
+
+void CoalescedWriter::send(const QString &value)
+{
+	m_in_flight = true;
+	m_echoed = false;
+	m_sent = value;
+	m_has_sent = true;
+
+	m_interval.start();
+	m_timeout.start();
+	m_stats.sent++;
+	m_write(value);
+}
+
+void CoalescedWriter::complete()
+{
+	m_in_flight = false;
+	m_interval.stop();
+	m_timeout.stop();
+
+	if (!m_has_pending)
+		return;
+
+	// the trailing write, with whatever was asked for last
+	m_has_pending = false;
+	if (!m_has_sent || m_sent != m_pending)
+		send(m_pending);
+}
+
+void CoalescedWriter::timedOut()
+{
+	// the write was lost: asking for the same value again must send it,
+	// but its echo may still turn up and isn't someone else's change
+	m_late.append(m_sent);
+	if (m_late.size() > MAX_LATE)
+		m_late.removeFirst();
+	m_has_sent = false;
+
+	complete();
+}
+
+bool CoalescedWriter::acknowledge(const QString &value)
+{
+	int pos;
+
+	if (m_in_flight && !m_echoed && m_has_sent && m_sent == value) {
+		m_stats.echoes++;
+		m_echoed = true;
+		if (!m_interval.isActive())
+			complete();
+		return true;
+	}
+
+	pos = m_late.indexOf(value);
+	if (pos < 0)
+		return false;
+
+	// echoes come in order, anything older was overtaken
+	m_late.erase(m_late.begin(), m_late.begin() + pos + 1);
+	m_stats.echoes++;
+	return true;
+}
+
+void CoalescedWriter::reset()
+{
+	m_in_flight = false;
+	m_has_pending = false;
+	m_has_sent = false;
+	m_late.clear();
+	m_interval.stop();
+	m_timeout.stop();
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef COALESCEDWRITER_H
+#define COALESCEDWRITER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <functional>
+
+/*
+ * Writes a value that changes faster than it is worth sending, such as a
+ * slider being dragged, with the latest value winning: at most one write is
+ * in flight, the values asked for meanwhile replace each other, and the
+ * last one is sent once the one in flight completes.
+ *
+ * A write completes when the broker echoes it back, and no sooner than
+ * MIN_INTERVAL_MS after it was sent, or after ACK_TIMEOUT_MS if the echo
+ * never comes. Echoes of our own writes are recognized by acknowledge(),
+ * so that the caller doesn't apply a value it has already moved past.
+ */
+class CoalescedWriter : public QObject
+{
+	Q_OBJECT
+public:
+	struct Stats {
+		quint64 requested = 0;
+		quint64 sent = 0;
+		quint64 echoes = 0;
+	};
+
+	using WriteFn = std::function<void(const QString &value)>;
+
+	explicit CoalescedWriter(WriteFn write, QObject *parent = nullptr);
+
+	void write(const QString &value);
+	/*
+	 * A value the broker reported. Returns true if it is the echo of one
+	 * of our writes, which the caller should then ignore.
+	 */
+	bool acknowledge(const QString &value);
+	/* forgets what is pending and in flight, e.g. once disconnected */
+	void reset();
+
+	const Stats &stats() const { return m_stats; }
+
+private:
+	void send(const QString &value);
+	void complete();
+	void timedOut();
+
+	WriteFn m_write;
+	QString m_pending;
+	bool m_has_pending = false;
+	bool m_in_flight = false;
+	bool m_echoed = false;
+	// what the broker has, or is getting, unless the write timed out
+	QString m_sent;
+	bool m_has_sent = false;
+	// timed out, oldest first: only there to recognize their late echoes
+	QStringList m_late;
+	QTimer m_interval;
+	QTimer m_timeout;
+	Stats m_stats;
+};
+
+#endif // COALESCEDWRITER_H
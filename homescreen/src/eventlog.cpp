@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QByteArray>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "eventlog.h"
+#include "hmi-debug.h"
+
+#define EVENT_LOG_MAGIC		"HSEV"
+#define EVENT_LOG_VERSION	1
+
+struct log_header {
+	char magic[4];
+	uint32_t version;
+	uint64_t start_realtime_us;
+};
+
+struct record_header {
+	uint64_t time_us;
+	uint8_t source;
+	uint8_t reserved;
+	uint16_t app_id_len;
+	uint16_t arg_len;
+	uint16_t code;
+};
+
+static_assert(sizeof(struct record_header) == 16, "record header isn't packed");
+
+static uint64_t
+clock_usec(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return (uint64_t) ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+EventRecorder *EventRecorder::fromEnvironment()
+{
+	const char *path = getenv("HOMESCREEN_EVENT_RECORD");
+	FILE *file;
+
+	if (!path || !*path)
+		return nullptr;
+
+	file = fopen(path, "wb");
+	if (!file) {
+		HMI_ERROR("HomeScreen", "Unable to record events to %s: %s",
+			  path, strerror(errno));
+		return nullptr;
+	}
+
+	return new EventRecorder(file);
+}
+
+EventRecorder::EventRecorder(FILE *file) :
+	m_file(file),
+	m_start_us(clock_usec(CLOCK_MONOTONIC))
+{
+	struct log_header header = {};
+
+	memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic));
+	header.version = EVENT_LOG_VERSION;
+	header.start_realtime_us = clock_usec(CLOCK_REALTIME);
+
+	fwrite(&header, sizeof(header), 1, m_file);
+	fflush(m_file);
+}
+
+EventRecorder::~EventRecorder()
+{
+	fclose(m_file);
+}
+
+/*
+ * Flushed after every event: there are a handful a second at most, and the
+ * log is most useful when the homescreen didn't exit cleanly.
+ */
+void EventRecorder::record(LoggedEvent::Source source, uint32_t code,
+			   const QString &app_id, const QString &arg)
+{
+	QByteArray app_id_utf8 = app_id.toUtf8().left(UINT16_MAX);
+	QByteArray arg_utf8 = arg.toUtf8().left(UINT16_MAX);
+	struct record_header header = {};
+
+	header.time_us = clock_usec(CLOCK_MONOTONIC) - m_start_us;
+	header.source = source;
+	header.code = code;
+	header.app_id_len = app_id_utf8.size();
+	header.arg_len = arg_utf8.size();
+
+	fwrite(&header, sizeof(header), 1, m_file);
+	fwrite(app_id_utf8.constData(), 1, app_id_utf8.size(), m_file);
+	fwrite(arg_utf8.constData(), 1, arg_utf8.size(), m_file);
+	fflush(m_file);
+}
+
+EventReader::~EventReader()
+{
+	if (m_file)
+		fclose(m_file);
+}
+
+bool EventReader::open(const QString &path)
+{
+	struct log_header header;
+
+	m_file = fopen(path.toLocal8Bit().constData(), "rb");
+	if (!m_file) {
+		m_error = QString::fromLocal8Bit(strerror(errno));
+		return false;
+	}
+
+	if (fread(&header, sizeof(header), 1, m_file) != 1 ||
+	    memcmp(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic)) != 0) {
+		m_error = QStringLiteral("not an event log");
+		return false;
+	}
+
+	if (header.version != EVENT_LOG_VERSION) {
+		m_error = QStringLiteral("unsupported event log version %1").arg(header.version);
+		return false;
+	}
+
+	m_start_realtime_us = header.start_realtime_us;
+	return true;
+}
+
+bool EventReader::next(LoggedEvent &event)
+{
+	struct record_header header;
+	QByteArray app_id, arg;
+
+	if (!m_file || fread(&header, sizeof(header), 1, m_file) != 1)
+		return false;
+
+	app_id.resize(header.app_id_len);
+	arg.resize(header.arg_len);
+	if (fread(app_id.data(), 1, app_id.size(), m_file) != (size_t) app_id.size() ||
+	    fread(arg.data(), 1, arg.size(), m_file) != (size_t) arg.size()) {
+		m_error = QStringLiteral("truncated event");
+		return false;
+	}
+
+	if (header.source < LoggedEvent::AppStatus || header.source > LoggedEvent::AppOnOutput) {
+		m_error = QStringLiteral("unknown event source %1").arg(header.source);
+		return false;
+	}
+
+	event.time_us = header.time_us;
+	event.source = static_cast<LoggedEvent::Source>(header.source);
+	event.code = header.code;
+	event.app_id = QString::fromUtf8(app_id);
+	event.arg = QString::fromUtf8(arg);
+	return true;
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <QString>
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * A compact binary log of the application lifecycle events entering
+ * HomescreenHandler, from applaunchd and from the compositor, so that an
+ * ordering seen in the field can be fed back to the handler with
+ * bench/event-replay.
+ *
+ * The file starts with a header (magic "HSEV", format version, wall clock
+ * time of the first event), followed by one record per event: a fixed
+ * 16-byte header with the time since the start of the recording, the
+ * source, a code and the lengths of the two UTF-8 strings that follow it,
+ * the app_id and the status or output. Integers are in host byte order.
+ */
+struct LoggedEvent {
+	enum Source : uint8_t {
+		/* AppLauncherClient::appStatusEvent */
+		AppStatus = 1,
+		/* agl_shell.app_state */
+		ShellAppState,
+		/* agl_shell.app_on_output */
+		AppOnOutput,
+	};
+
+	uint64_t time_us = 0;
+	Source source = AppStatus;
+	/* the agl_shell state for ShellAppState */
+	uint32_t code = 0;
+	QString app_id;
+	/* the status for AppStatus, the output for AppOnOutput */
+	QString arg;
+};
+
+class EventRecorder
+{
+public:
+	/* a recorder writing to HOMESCREEN_EVENT_RECORD, if it is set */
+	static EventRecorder *fromEnvironment();
+
+	explicit EventRecorder(FILE *file);
+	~EventRecorder();
+
+	EventRecorder(const EventRecorder &) = delete;
+	EventRecorder &operator=(const EventRecorder &) = delete;
+
+	void record(LoggedEvent::Source source, uint32_t code,
+		    const QString &app_id, const QString &arg = QString());
+
+private:
+	FILE *m_file;
+	uint64_t m_start_us;
+};
+
+class EventReader
+{
+public:
+	EventReader() = default;
+	~EventReader();
+
+	EventReader(const EventReader &) = delete;
+	EventReader &operator=(const EventReader &) = delete;
+
+	bool open(const QString &path);
+	/* false at the end of the log, or on error */
+	bool next(LoggedEvent &event);
+
+	/* wall clock time of the start of the recording, in microseconds */
+	uint64_t startTime() const { return m_start_realtime_us; }
+	const QString &errorString() const { return m_error; }
+
+private:
+	FILE *m_file = nullptr;
+	uint64_t m_start_realtime_us = 0;
+	QString m_error;
+};
+
+#endif // EVENTLOG_H
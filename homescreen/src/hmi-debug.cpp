@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mutex>
+#include <thread>
+
+#include <errno.h>
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "boundedqueue.h"
+#include "hmi-debug.h"
+
+#define LOG_ENTRY_SIZE		512
+#define LOG_QUEUE_ENTRIES	256
+
+std::atomic<int> _hmi_log_level{-1};
+
+static const char ERROR_FLAG[6][20] = {"NONE", "ERROR", "WARNING", "NOTICE", "INFO", "DEBUG"};
+
+struct log_entry {
+	struct timespec tp;
+	char text[LOG_ENTRY_SIZE - sizeof(struct timespec)];
+};
+
+struct log_writer {
+	BoundedQueue<log_entry, LOG_QUEUE_ENTRIES> queue;
+	std::atomic<unsigned long> dropped{0};
+	std::atomic<bool> running{false};
+	std::atomic<bool> stopping{false};
+	/* set while the writer is (about to be) blocked on wakeup */
+	std::atomic<bool> idle{false};
+	std::once_flag started;
+	std::mutex flush_lock;
+	std::thread thread;
+	sem_t wakeup;
+
+	log_writer()
+	{
+		sem_init(&wakeup, 0, 0);
+	}
+};
+
+static void writer_stop(void);
+
+/*
+ * Never destroyed, so that messages logged from other static destructors
+ * still have somewhere to go; they are written synchronously once the
+ * writer thread has been stopped at exit.
+ */
+static log_writer &
+writer()
+{
+	static log_writer *w = new log_writer;
+	return *w;
+}
+
+static void
+write_all(const char *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t ret = write(STDERR_FILENO, buf, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+		buf += ret;
+		len -= ret;
+	}
+}
+
+/* keeps the timestamp format of the original synchronous logger */
+static int
+format_line(char *buf, size_t size, const log_entry &entry)
+{
+	uint32_t time = (entry.tp.tv_sec * 1000000L) + (entry.tp.tv_nsec / 1000);
+	int len;
+
+	if (entry.tp.tv_nsec % 1000 >= 500)
+		time++;
+
+	len = snprintf(buf, size, "[%10.3f] %s \n", time / 1000.0, entry.text);
+	if (len < 0)
+		return 0;
+	return (size_t) len < size ? len : size - 1;
+}
+
+/*
+ * Drains the queue in batches, so that a burst of messages ends up in a
+ * handful of write() calls rather than one per message.
+ */
+static void
+drain(log_writer &w)
+{
+	char batch[16 * 1024];
+	size_t used = 0;
+	unsigned long dropped;
+
+	std::lock_guard<std::mutex> guard(w.flush_lock);
+
+	while (w.queue.pop_with([&](log_entry &entry) {
+		if (sizeof(batch) - used < LOG_ENTRY_SIZE + 32) {
+			write_all(batch, used);
+			used = 0;
+		}
+		used += format_line(batch + used, sizeof(batch) - used, entry);
+	}))
+		;
+
+	dropped = w.dropped.exchange(0);
+	if (dropped)
+		used += snprintf(batch + used, sizeof(batch) - used,
+				 "[hmi-debug] %lu messages dropped\n", dropped);
+
+	if (used)
+		write_all(batch, used);
+}
+
+static void
+writer_main(log_writer *w)
+{
+	while (!w->stopping) {
+		w->idle = true;
+		/* a producer may have pushed before seeing idle set */
+		if (w->queue.empty() && !w->stopping)
+			while (sem_wait(&w->wakeup) < 0 && errno == EINTR)
+				;
+		w->idle = false;
+		drain(*w);
+	}
+
+	drain(*w);
+}
+
+int _HMI_LOG_INIT(void)
+{
+	const char *env = getenv("USE_HMI_DEBUG");
+	int level = env ? atoi(env) : LOG_LEVEL_ERROR;
+	int expected = -1;
+
+	if (level < LOG_LEVEL_NONE)
+		level = LOG_LEVEL_NONE;
+
+	/* another thread, or _HMI_LOG_SET_LEVEL(), may have been first */
+	if (!_hmi_log_level.compare_exchange_strong(expected, level))
+		return expected;
+	return level;
+}
+
+void _HMI_LOG_SET_LEVEL(int level)
+{
+	_hmi_log_level = level < LOG_LEVEL_NONE ? LOG_LEVEL_NONE : level;
+}
+
+static void
+writer_stop(void)
+{
+	log_writer &w = writer();
+
+	w.stopping = true;
+	sem_post(&w.wakeup);
+	w.thread.join();
+	w.running = false;
+}
+
+void _HMI_LOG_FLUSH(void)
+{
+	drain(writer());
+}
+
+void _HMI_LOG(enum LOG_LEVEL level, const char* file, const char* func, const int line, const char* prefix, const char* log, ...)
+{
+	log_writer &w = writer();
+	va_list args;
+	bool queued;
+
+	if (level < LOG_LEVEL_NONE || level > LOG_LEVEL_MAX)
+		return;
+
+	std::call_once(w.started, [&w]() {
+		if (w.stopping)
+			return;
+		w.thread = std::thread(writer_main, &w);
+		w.running = true;
+		atexit(writer_stop);
+	});
+
+	va_start(args, log);
+	queued = w.queue.push_with([&](log_entry &entry) {
+		size_t size = sizeof(entry.text);
+		int len;
+
+		clock_gettime(CLOCK_REALTIME, &entry.tp);
+		len = snprintf(entry.text, size, "[%s %s] [%s, %s(), Line:%d] >>> ",
+			       prefix, ERROR_FLAG[level], file, func, line);
+		if (len >= 0 && (size_t) len < size)
+			vsnprintf(entry.text + len, size - len, log, args);
+	});
+	va_end(args);
+
+	if (!queued) {
+		w.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	/* past the writer's lifetime (logging from exit handlers) */
+	if (w.stopping || !w.running) {
+		drain(w);
+		return;
+	}
+
+	/* only pay for the futex wake when the writer is asleep */
+	if (w.idle.exchange(false))
+		sem_post(&w.wakeup);
+}
@@ -17,11 +17,8 @@
 #ifndef __HMI_DEBUG_H__
 #define __HMI_DEBUG_H__
 
-#include <time.h>
-#include <stdio.h>
-#include <stdarg.h>
+#include <atomic>
 #include <string.h>
-#include <stdlib.h>
 
 enum LOG_LEVEL{
     LOG_LEVEL_NONE = 0,
@@ -35,44 +32,45 @@ enum LOG_LEVEL{
 
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 
-#define HMI_ERROR(prefix, args,...) _HMI_LOG(LOG_LEVEL_ERROR, __FILENAME__, __FUNCTION__, __LINE__, prefix, args, ##__VA_ARGS__)
-#define HMI_WARNING(prefix, args,...) _HMI_LOG(LOG_LEVEL_WARNING, __FILENAME__, __FUNCTION__,__LINE__, prefix, args,##__VA_ARGS__)
-#define HMI_NOTICE(prefix, args,...) _HMI_LOG(LOG_LEVEL_NOTICE, __FILENAME__, __FUNCTION__,__LINE__, prefix, args,##__VA_ARGS__)
-#define HMI_INFO(prefix, args,...)  _HMI_LOG(LOG_LEVEL_INFO, __FILENAME__, __FUNCTION__,__LINE__, prefix, args,##__VA_ARGS__)
-#define HMI_DEBUG(prefix, args,...) _HMI_LOG(LOG_LEVEL_DEBUG, __FILENAME__, __FUNCTION__,__LINE__, prefix, args,##__VA_ARGS__)
+/*
+ * The level comes from USE_HMI_DEBUG and is read once, on first use. The
+ * macros check it before evaluating any of their arguments, so a disabled
+ * statement costs a single relaxed load and a compare.
+ *
+ * Enabled messages are formatted by the caller into a fixed-size entry and
+ * handed to a background writer through a lock-free ring buffer; the caller
+ * never blocks on stderr. When the ring is full the message is dropped and
+ * counted, and the writer reports the number of drops. Everything still
+ * queued is written out at exit, or by _HMI_LOG_FLUSH().
+ */
+extern std::atomic<int> _hmi_log_level;
 
-static char ERROR_FLAG[6][20] = {"NONE", "ERROR", "WARNING", "NOTICE", "INFO", "DEBUG"};
+int _HMI_LOG_INIT(void);
+void _HMI_LOG_SET_LEVEL(int level);
+void _HMI_LOG_FLUSH(void);
+void _HMI_LOG(enum LOG_LEVEL level, const char* file, const char* func, const int line, const char* prefix, const char* log, ...)
+    __attribute__((format(printf, 6, 7)));
 
-static void _HMI_LOG(enum LOG_LEVEL level, const char* file, const char* func, const int line, const char* prefix, const char* log, ...)
+static inline bool _HMI_LOG_ENABLED(enum LOG_LEVEL level)
 {
-    char *message;
-    struct timespec tp;
-    uint32_t time;
-    va_list args;
-    const int log_level = (getenv("USE_HMI_DEBUG") == NULL) ? LOG_LEVEL_ERROR : atoi(getenv("USE_HMI_DEBUG"));
+    int log_level = _hmi_log_level.load(std::memory_order_relaxed);
 
-    if(log_level < level) {
-        return;
-    }
+    if (__builtin_expect(log_level < 0, 0))
+        log_level = _HMI_LOG_INIT();
 
-    va_start(args, log);
-    if (vasprintf(&message, log, args) < 0) {
-	fprintf(stderr, "Warning: message is NULL\n");
-	vfprintf(stderr, log, args);
-	fprintf(stderr, "\n");
-	message = NULL;
-    }
-
-    clock_gettime(CLOCK_REALTIME, &tp);
-    time = (tp.tv_sec * 1000000L) + (tp.tv_nsec / 1000);
-    if (tp.tv_nsec % 1000 >= 500) {
-        time++;
-    }
+    return level <= log_level;
+}
 
-    fprintf(stderr,  "[%10.3f] [%s %s] [%s, %s(), Line:%d] >>> %s \n", time / 1000.0, prefix, ERROR_FLAG[level], file, func, line, message);
+#define _HMI_LOG_IF(level, prefix, args, ...) \
+    do { \
+        if (_HMI_LOG_ENABLED(level)) \
+            _HMI_LOG(level, __FILENAME__, __FUNCTION__, __LINE__, prefix, args, ##__VA_ARGS__); \
+    } while (0)
 
-    va_end(args);
-    free(message);
-}
+#define HMI_ERROR(prefix, args,...) _HMI_LOG_IF(LOG_LEVEL_ERROR, prefix, args, ##__VA_ARGS__)
+#define HMI_WARNING(prefix, args,...) _HMI_LOG_IF(LOG_LEVEL_WARNING, prefix, args, ##__VA_ARGS__)
+#define HMI_NOTICE(prefix, args,...) _HMI_LOG_IF(LOG_LEVEL_NOTICE, prefix, args, ##__VA_ARGS__)
+#define HMI_INFO(prefix, args,...)  _HMI_LOG_IF(LOG_LEVEL_INFO, prefix, args, ##__VA_ARGS__)
+#define HMI_DEBUG(prefix, args,...) _HMI_LOG_IF(LOG_LEVEL_DEBUG, prefix, args, ##__VA_ARGS__)
 
 #endif  //__HMI_DEBUG_H__
@@ -11,25 +11,24 @@
 #include "homescreenhandler.h"
 #include "hmi-debug.h"
 
-QScreen *find_screen(const char *output);
-
-// defined by meson build file
-#include QT_QPA_HEADER
-
 // LAUNCHER_APP_ID shouldn't be started by applaunchd as it is started as
 // a user session by systemd
 #define LAUNCHER_APP_ID          "launcher"
 
-static struct wl_output *
-getWlOutput(QPlatformNativeInterface *native, QScreen *screen);
-
-HomescreenHandler::HomescreenHandler(Shell *_aglShell, ApplicationLauncher *launcher, QObject *parent) :
+HomescreenHandler::HomescreenHandler(Shell *_aglShell, OutputRegistry *outputs,
+				     ApplicationLauncher *launcher, QObject *parent) :
 	QObject(parent),
-	aglShell(_aglShell)
+	aglShell(_aglShell),
+	m_outputs(outputs)
 {
 	mp_launcher = launcher;
 	mp_applauncher_client = new AppLauncherClient();
-	QPlatformNativeInterface *native = qApp->platformNativeInterface();
+	m_latency = new SwitchLatency(this);
+	m_prelauncher = new Prelauncher(mp_applauncher_client,
+		[this](const QString &app_id) { return isAppRunning(app_id); }, this);
+	m_activations = new ActivationCoalescer(outputs,
+		[this](const QString &app_id) { activateApp(app_id); }, this);
+	m_recorder = EventRecorder::fromEnvironment();
 
 	//
 	// The "started" event is received any time a start request is made to applaunchd,
@@ -39,27 +38,35 @@ HomescreenHandler::HomescreenHandler(Shell *_aglShell, ApplicationLauncher *laun
 	connect(mp_applauncher_client,
 		&AppLauncherClient::appStatusEvent,
 		this,
-		&HomescreenHandler::processAppStatusEvent);
+		[this](const QString &app_id, const QString &status) {
+			if (m_recorder)
+				m_recorder->record(LoggedEvent::AppStatus, 0, app_id, status);
+			processAppStatusEvent(app_id, status);
+		});
 }
 
 HomescreenHandler::~HomescreenHandler()
 {
+	delete m_recorder;
 	delete mp_applauncher_client;
 }
 
-static struct wl_output *
-getWlOutput(QPlatformNativeInterface *native, QScreen *screen)
+void HomescreenHandler::detachFromLauncher()
 {
-	void *output = native->nativeResourceForScreen("output", screen);
-	return static_cast<struct ::wl_output*>(output);
+	disconnect(mp_applauncher_client, nullptr, this, nullptr);
 }
 
 void HomescreenHandler::tapShortcut(QString app_id)
 {
 	HMI_DEBUG("HomeScreen","tapShortcut %s", app_id.toStdString().c_str());
 
+	// a pre-launched application only needs activating now
+	bool prelaunched = m_prelauncher->claim(app_id);
+	m_prelauncher->noteActivity();
+	m_latency->mark(app_id, SwitchLatency::Tap, !isAppRunning(app_id) && !prelaunched);
+
 	if (app_id == LAUNCHER_APP_ID) {
-		activateApp(app_id);
+		m_activations->request(app_id);
 		return;
 	}
 
@@ -68,95 +75,204 @@ void HomescreenHandler::tapShortcut(QString app_id)
 			  app_id.toStdString().c_str());
 		return;
 	}
+
+	m_latency->mark(app_id, SwitchLatency::LaunchRequested, !isAppRunning(app_id));
+	m_prelauncher->recordActivation(app_id);
 }
 
 /*
  * Keep track of currently running apps and the order in which
- * they were activated. That way, when an app is closed, we can
- * switch back to the previously active one.
+ * they were activated on each output. That way, when an app is
+ * closed, we can switch back to the previously active one.
  */
 void HomescreenHandler::addAppToStack(const QString& app_id)
 {
 	if (app_id == "homescreen")
 		return;
 
-	if (!apps_stack.contains(app_id)) {
-		apps_stack << app_id;
-	} else {
-		int current_pos = apps_stack.indexOf(app_id);
-		int last_pos = apps_stack.size() - 1;
+	// only what the user asks for counts towards the ranking, see
+	// tapShortcut() and processAppEvent(), not pre-launches or the
+	// previous application coming back
+	m_prelauncher->noteActivity();
 
-		if (current_pos != last_pos)
-			apps_stack.move(current_pos, last_pos);
-	}
+	QString output = m_activation_output.take(app_id);
+	if (output.isEmpty())
+		output = m_apps.outputOf(app_id);
+	if (output.isEmpty())
+		output = m_outputs->defaultOutput().name;
+
+	m_apps.push(app_id, output);
+}
+
+void HomescreenHandler::setPendingOutput(const QString& app_id, const QString& output)
+{
+	m_outputs->setPendingOutput(app_id, output);
 }
 
 void HomescreenHandler::activateApp(const QString& app_id)
 {
 	struct agl_shell *agl_shell = aglShell->shell.get();
-	QPlatformNativeInterface *native = qApp->platformNativeInterface();
-	struct wl_output *mm_output = getWlOutput(native, qApp->screens().first());
+	AppId app = AppIdTable::intern(app_id);
+	const char *app_utf8 = AppIdTable::utf8(app);
+	// an application might have been routed to another output
+	OutputRegistry::Output output = m_outputs->takePendingOutput(app_id);
 
 	if (mp_launcher) {
-		mp_launcher->setCurrent(app_id);
+		mp_launcher->setCurrentApp(app);
 	}
-	HMI_DEBUG("HomeScreen", "Activating app_id %s by default output %p\n",
-			app_id.toStdString().c_str(), mm_output);
-
-	// search for a pending application which might have a different output
-	auto iter = pending_app_list.begin();
-	bool found_pending_app = false;
-	while (iter != pending_app_list.end()) {
-		const QString &app_to_search = iter->first;
-
-		if (app_to_search == app_id) {
-			found_pending_app = true;
-			break;
-		}
-
-		iter++;
-	}
-
-	if (found_pending_app) {
-		const QString &output_name = iter->second;
-		QScreen *screen =
-			::find_screen(output_name.toStdString().c_str());
-
-		mm_output = getWlOutput(native, screen);
-		pending_app_list.erase(iter);
 
+	if (output.isValid()) {
 		HMI_DEBUG("HomeScreen", "For application %s found another "
 				"output to activate %s\n",
-				app_id.toStdString().c_str(),
-				output_name.toStdString().c_str());
+				app_utf8, output.name.toStdString().c_str());
+	} else {
+		output = m_outputs->defaultOutput();
+		HMI_DEBUG("HomeScreen", "Activating app_id %s by default output %p\n",
+				app_utf8, output.wl_output);
 	}
 
-	HMI_DEBUG("HomeScreen", "Activating application %s",
-			app_id.toStdString().c_str());
+	if (output.isValid())
+		m_activation_output.insert(app_id, output.name);
+
+	HMI_DEBUG("HomeScreen", "Activating application %s", app_utf8);
 
-	agl_shell_activate_app(agl_shell, app_id.toStdString().c_str(), mm_output);
+	m_latency->mark(app_id, SwitchLatency::ActivateSent, !isAppRunning(app_id));
+	// there's no shell when replaying recorded events
+	if (agl_shell)
+		agl_shell_activate_app(agl_shell, app_utf8, output.wl_output);
+	emit activationSent(app_id, output.name);
 }
 
 void HomescreenHandler::deactivateApp(const QString& app_id)
 {
-	if (apps_stack.contains(app_id)) {
-		apps_stack.removeOne(app_id);
-		if (!apps_stack.isEmpty())
-			activateApp(apps_stack.last());
+	QString output = m_apps.outputOf(app_id);
+
+	m_activation_output.remove(app_id);
+	if (!m_apps.remove(app_id))
+		return;
+
+	// bring back the previous app on the output the closed one was on
+	QString previous = m_apps.top(output);
+	if (!previous.isEmpty()) {
+		m_outputs->setPendingOutput(previous, output);
+		m_activations->request(previous);
 	}
 }
 
 void HomescreenHandler::processAppStatusEvent(const QString &app_id, const QString &status)
 {
+	AppEvent event = appEventFromStatus(status);
+
+	if (event == AppEvent::None) {
+		HMI_DEBUG("HomeScreen", "Ignoring application %s, status %s",
+			  app_id.toStdString().c_str(), status.toStdString().c_str());
+		return;
+	}
+
+	if (event == AppEvent::Started &&
+	    m_prelauncher->takePrelaunchStart(app_id, Prelauncher::LauncherStart)) {
+		HMI_DEBUG("HomeScreen", "Application %s pre-launched, leaving it in the background",
+			  app_id.toStdString().c_str());
+		return;
+	}
+
+	processAppEvent(AppIdTable::intern(app_id), event);
+}
+
+void HomescreenHandler::processAppEvent(AppId app, AppEvent event)
+{
+	QString app_id = AppIdTable::name(app);
+
 	HMI_DEBUG("HomeScreen", "Processing application %s, status %s",
-			app_id.toStdString().c_str(), status.toStdString().c_str());
+		  AppIdTable::utf8(app), appEventName(event));
 
-	if (status == "started") {
-		activateApp(app_id);
-	} else if (status == "terminated") {
-		HMI_DEBUG("HomeScreen", "Application %s terminated, activating last app", app_id.toStdString().c_str());
+	switch (event) {
+	case AppEvent::Started:
+		// started some other way than through a shortcut
+		if (m_prelauncher->claim(app_id))
+			m_prelauncher->recordActivation(app_id);
+
+		// both the compositor and applaunchd report starts
+		m_latency->mark(app_id, SwitchLatency::Started, !isAppRunning(app_id));
+		m_activations->request(app_id);
+		break;
+	case AppEvent::Terminated:
+		HMI_DEBUG("HomeScreen", "Application %s terminated, activating last app",
+			  AppIdTable::utf8(app));
+		m_prelauncher->forget(app_id);
 		deactivateApp(app_id);
-	} else if (status == "deactivated") {
-		HMI_DEBUG("HomeScreen", "Application %s deactivated, activating last app", app_id.toStdString().c_str());
+		break;
+	case AppEvent::Deactivated:
+		HMI_DEBUG("HomeScreen", "Application %s deactivated, activating last app",
+			  AppIdTable::utf8(app));
+		break;
+	default:
+		break;
+	}
+}
+
+void HomescreenHandler::processShellAppState(AppId app, uint32_t state)
+{
+	AppEvent event = appEventFromShellState(state);
+
+	if (m_recorder)
+		m_recorder->record(LoggedEvent::ShellAppState, state, AppIdTable::name(app));
+
+	HMI_DEBUG("HomeScreen", "Got app_state %s for app_id %s",
+		  appEventName(event), AppIdTable::utf8(app));
+
+	switch (event) {
+	case AppEvent::Started:
+		if (m_prelauncher->takePrelaunchStart(AppIdTable::name(app), Prelauncher::ShellStart)) {
+			HMI_DEBUG("HomeScreen", "Application %s pre-launched, leaving it in the background",
+				  AppIdTable::utf8(app));
+			break;
+		}
+		processAppEvent(app, event);
+		break;
+	case AppEvent::Deactivated:
+		processAppEvent(app, event);
+		break;
+	case AppEvent::Terminated:
+		// handled by HomescreenHandler::processAppStatusEvent
+		break;
+	case AppEvent::Activated: {
+		QString app_id = AppIdTable::name(app);
+
+		m_latency->finish(app_id);
+		addAppToStack(app_id);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void HomescreenHandler::processAppOnOutput(AppId app, const QString &output)
+{
+	QString app_id = AppIdTable::name(app);
+
+	// a couple of use-cases, if there is no app_id in the app_list then it
+	// means this is a request to map the application, from the start to a
+	// different output that the default one. We'd get an
+	// AGL_SHELL_APP_STATE_STARTED which will handle activation.
+	//
+	// if there's an app_id then it means we might have gotten an event to
+	// move the application to another output; so we'd need to process it
+	// by explicitly calling processAppEvent() which would ultimately
+	// activate the application on other output. We'd have to pick-up the
+	// last activated window and activate the default output.
+	//
+	// finally if the outputs are identical probably that's an user-error -
+	// but the compositor won't activate it again, so we don't handle that.
+	if (m_recorder)
+		m_recorder->record(LoggedEvent::AppOnOutput, 0, app_id, output);
+
+	setPendingOutput(app_id, output);
+
+	if (isAppRunning(app_id)) {
+		HMI_DEBUG("HomeScreen", "Got event to move %s to another output %s",
+			  AppIdTable::utf8(app), output.toStdString().c_str());
+		processAppEvent(app, AppEvent::Started);
 	}
 }
@@ -10,8 +10,15 @@
 #include <QObject>
 #include <string>
 
+#include "appid.h"
 #include "applicationlauncher.h"
 #include "AppLauncherClient.h"
+#include "activationcoalescer.h"
+#include "appstack.h"
+#include "eventlog.h"
+#include "outputregistry.h"
+#include "prelauncher.h"
+#include "switchlatency.h"
 
 #include "shell.h"
 
@@ -21,7 +28,8 @@ class HomescreenHandler : public QObject
 {
 	Q_OBJECT
 public:
-	explicit HomescreenHandler(Shell *aglShell, ApplicationLauncher *launcher = 0, QObject *parent = 0);
+	explicit HomescreenHandler(Shell *aglShell, OutputRegistry *outputs,
+				   ApplicationLauncher *launcher = 0, QObject *parent = 0);
 	~HomescreenHandler();
 
 	Q_INVOKABLE void tapShortcut(QString application_id);
@@ -30,13 +38,29 @@ public:
 	void activateApp(const QString& app_id);
 	void deactivateApp(const QString& app_id);
 
-	QStringList apps_stack;
-	std::list<std::pair<const QString, const QString>> pending_app_list;
+	bool isAppRunning(const QString& app_id) const { return m_apps.contains(app_id); }
+	const AppStack &appStack() const { return m_apps; }
+	const ActivationCoalescer::Stats &activationStats() const { return m_activations->stats(); }
+
+	/* stops taking applaunchd's events, so that only replayed ones come in */
+	void detachFromLauncher();
+
+	/* shows app_id on output the next time it gets activated */
+	void setPendingOutput(const QString& app_id, const QString& output);
+
+	void processAppEvent(AppId app, AppEvent event);
+
+	/* agl_shell events, delivered by ShellEventQueue */
+	void processShellAppState(AppId app, uint32_t state);
+	void processAppOnOutput(AppId app, const QString& output);
 signals:
 	void showNotification(QString application_id, QString icon_path, QString text);
 	void showInformation(QString info);
+	/* agl_shell_activate_app() was sent, or would have been without a shell */
+	void activationSent(const QString &app_id, const QString &output);
 
 public slots:
+	/* applaunchd's appStatusEvent */
 	void processAppStatusEvent(const QString &id, const QString &status);
 
 private:
@@ -44,7 +68,16 @@ private:
 	AppLauncherClient *mp_applauncher_client;
 
 	Shell *aglShell;
+	OutputRegistry *m_outputs;
+	ActivationCoalescer *m_activations;
+	SwitchLatency *m_latency;
+	Prelauncher *m_prelauncher;
+	EventRecorder *m_recorder;
 
+	AppStack m_apps;
+	// output each application was last asked to activate on, until the
+	// compositor confirms the activation
+	QHash<QString, QString> m_activation_output;
 };
 
 #endif // HOMESCREENHANDLER_H
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QPainter>
+#include <QVector>
+
+#include <algorithm>
+
+#include "iconatlasprovider.h"
+
+#define ATLAS_WIDTH		1024
+// anything bigger isn't an icon, and would waste atlas space
+#define MAX_ICON_SIZE		256
+// keeps filtering at the edges from picking up the neighbours
+#define ICON_PADDING		1
+
+static const char *const icon_dirs[] = {
+	"Status",
+	"Weather",
+	"MediaPlayer",
+};
+
+struct atlas_icon {
+	QString id;
+	QImage image;
+};
+
+static void
+release_atlas(void *info)
+{
+	delete static_cast<QImage *>(info);
+}
+
+IconAtlasProvider::IconAtlasProvider() :
+	QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+/*
+ * Shelf packing, tallest icons first, which is close enough to optimal for
+ * a few dozen icons of similar sizes.
+ */
+void IconAtlasProvider::build()
+{
+	QVector<atlas_icon> icons;
+	QVector<QPoint> positions;
+	int x = 0, y = 0, shelf = 0;
+
+	for (const char *dir : icon_dirs) {
+		QDirIterator it(QStringLiteral(":/images/%1").arg(QLatin1String(dir)),
+				{ QStringLiteral("*.png") }, QDir::Files);
+
+		while (it.hasNext()) {
+			QString path = it.next();
+			QImage image(path);
+
+			if (image.isNull() || image.width() > MAX_ICON_SIZE ||
+			    image.height() > MAX_ICON_SIZE)
+				continue;
+
+			icons.append({ QStringLiteral("%1/%2").arg(QLatin1String(dir),
+								   QFileInfo(path).fileName()),
+				       image.convertToFormat(QImage::Format_ARGB32_Premultiplied) });
+		}
+	}
+
+	std::sort(icons.begin(), icons.end(), [](const atlas_icon &a, const atlas_icon &b) {
+		return a.image.height() > b.image.height();
+	});
+
+	for (const atlas_icon &icon : qAsConst(icons)) {
+		if (x + icon.image.width() > ATLAS_WIDTH) {
+			x = 0;
+			y += shelf + ICON_PADDING;
+			shelf = 0;
+		}
+		positions.append(QPoint(x, y));
+		x += icon.image.width() + ICON_PADDING;
+		shelf = std::max(shelf, icon.image.height());
+	}
+
+	if (icons.isEmpty())
+		return;
+
+	m_atlas = QImage(ATLAS_WIDTH, y + shelf, QImage::Format_ARGB32_Premultiplied);
+	m_atlas.fill(Qt::transparent);
+
+	QPainter painter(&m_atlas);
+	painter.setCompositionMode(QPainter::CompositionMode_Source);
+	for (int i = 0; i < icons.size(); i++) {
+		painter.drawImage(positions[i], icons[i].image);
+		m_rects.insert(icons[i].id, QRect(positions[i], icons[i].image.size()));
+	}
+	painter.end();
+
+	qDebug() << "Packed" << icons.size() << "icons in a" << m_atlas.size() << "atlas";
+}
+
+QImage IconAtlasProvider::requestImage(const QString &id, QSize *size,
+				       const QSize &requestedSize)
+{
+	QImage image;
+
+	std::call_once(m_built, [this]() { build(); });
+
+	auto it = m_rects.constFind(id);
+	if (it != m_rects.constEnd()) {
+		const QRect &rect = it.value();
+		const uchar *bits = m_atlas.constBits() + rect.y() * m_atlas.bytesPerLine() +
+				    rect.x() * 4;
+
+		// the copy of m_atlas keeps the memory alive for as long as the view
+		image = QImage(bits, rect.width(), rect.height(), m_atlas.bytesPerLine(),
+			       m_atlas.format(), release_atlas, new QImage(m_atlas));
+	} else {
+		image.load(QStringLiteral(":/images/%1").arg(id));
+		if (image.isNull())
+			qWarning() << "Unable to load icon" << id;
+	}
+
+	if (size)
+		*size = image.size();
+
+	if (!image.isNull() && requestedSize.width() > 0 && requestedSize.height() > 0 &&
+	    requestedSize != image.size())
+		image = image.scaled(requestedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+	return image;
+}
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ICONATLASPROVIDER_H
+#define ICONATLASPROVIDER_H
+
+#include <QHash>
+#include <QImage>
+#include <QQuickImageProvider>
+#include <QRect>
+#include <QString>
+
+#include <mutex>
+
+/*
+ * Serves the small status, weather and media player icons as
+ * image://icons/<directory>/<file>, e.g. image://icons/Status/foo.png for
+ * :/images/Status/foo.png.
+ *
+ * The first request decodes every icon of those directories once and packs
+ * them into a single atlas; each request then gets a QImage sharing the
+ * atlas memory for its sub-rectangle, so changing an icon costs neither a
+ * decode nor a copy. Icons too large for the atlas are decoded on their own,
+ * and anything requested at another size is scaled from its source.
+ */
+class IconAtlasProvider : public QQuickImageProvider
+{
+public:
+	IconAtlasProvider();
+
+	QImage requestImage(const QString &id, QSize *size,
+			    const QSize &requestedSize) override;
+
+private:
+	void build();
+
+	std::once_flag m_built;
+	QImage m_atlas;
+	QHash<QString, QRect> m_rects;
+};
+
+#endif // ICONATLASPROVIDER_H
@@ -15,15 +15,29 @@
 #include <QtQml/qqml.h>
 #include <QQuickWindow>
 #include <QTimer>
+#include <QFile>
+#include <QResource>
+#include <climits>
 
 #include <weather.h>
 #include <bluetooth.h>
 
 #include "applicationlauncher.h"
 #include "statusbarmodel.h"
+#include "statussnapshot.h"
 #include "mastervolume.h"
+#include "vehiclesignalhub.h"
 #include "homescreenhandler.h"
+#include "outputregistry.h"
+#include "shellevents.h"
+#include "readytracker.h"
+#include "shellloader.h"
+#include "backgroundprovider.h"
+#include "iconatlasprovider.h"
+#include "svgrastercache.h"
+#include "wallclock.h"
 #include "hmi-debug.h"
+#include "startuptrace.h"
 
 // meson will define these
 #include QT_QPA_HEADER
@@ -36,47 +50,35 @@
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
-QScreen *
-find_screen(const char *screen_name)
-{
-	QList<QScreen *> screens = qApp->screens();
-	QScreen *found = nullptr;
-	QString qstr_name = QString::fromUtf8(screen_name, -1);
-
-	for (QScreen *xscreen : screens) {
-		if (qstr_name == xscreen->name()) {
-			found = xscreen;
-			break;
-		}
-	}
-
-	return found;
-}
+// upper bound on how long we wait for the first frame of our surfaces
+// before telling the compositor we're ready anyway
+#define READY_TIMEOUT_MS_DEFAULT	2000
 
 struct shell_data {
 	struct agl_shell *shell;
-	HomescreenHandler *homescreenHandler;
-	bool wait_for_bound;
-	bool bound_ok;
+	ShellEventQueue *events;
 	int ver;
 };
 
+/*
+ * The listeners below run on the agl_shell dispatch thread (see
+ * ShellEventQueue), except for anything sent before it starts, which is
+ * dispatched by the registry roundtrip in register_agl_shell().
+ */
 static void
 agl_shell_bound_ok(void *data, struct agl_shell *agl_shell)
 {
 	struct shell_data *shell_data = static_cast<struct shell_data *>(data);
-	shell_data->wait_for_bound = false;
 
-	shell_data->bound_ok = true;
+	shell_data->events->setBound(true);
 }
 
 static void
 agl_shell_bound_fail(void *data, struct agl_shell *agl_shell)
 {
 	struct shell_data *shell_data = static_cast<struct shell_data *>(data);
-	shell_data->wait_for_bound = false;
 
-	shell_data->bound_ok = false;
+	shell_data->events->setBound(false);
 }
 
 static void
@@ -84,31 +86,12 @@ agl_shell_app_state(void *data, struct agl_shell *agl_shell,
 		const char *app_id, uint32_t state)
 {
 	struct shell_data *shell_data = static_cast<struct shell_data *>(data);
-	HomescreenHandler *homescreenHandler = shell_data->homescreenHandler;
-
-	if (!homescreenHandler)
-		return;
+	ShellEventQueue::Event event;
 
-	switch (state) {
-	case AGL_SHELL_APP_STATE_STARTED:
-		qDebug() << "Got AGL_SHELL_APP_STATE_STARTED for app_id " << app_id;
-		homescreenHandler->processAppStatusEvent(app_id, "started");
-		break;
-	case AGL_SHELL_APP_STATE_TERMINATED:
-		qDebug() << "Got AGL_SHELL_APP_STATE_TERMINATED for app_id " << app_id;
-		// handled by HomescreenHandler::processAppStatusEvent
-		break;
-	case AGL_SHELL_APP_STATE_ACTIVATED:
-		qDebug() << "Got AGL_SHELL_APP_STATE_ACTIVATED for app_id " << app_id;
-		homescreenHandler->addAppToStack(app_id);
-		break;
-	case AGL_SHELL_APP_STATE_DEACTIVATED:
-		qDebug() << "Got AGL_SHELL_APP_STATE_DEACTIVATED for app_id " << app_id;
-		homescreenHandler->processAppStatusEvent(app_id, "deactivated");
-		break;
-	default:
-		break;
-	}
+	event.type = ShellEventQueue::AppState;
+	event.state = state;
+	event.app_id = AppIdTable::intern(app_id);
+	shell_data->events->post(std::move(event));
 }
 
 static void
@@ -116,33 +99,12 @@ agl_shell_app_on_output(void *data, struct agl_shell *agl_shell,
 		const char *app_id, const char *output_name)
 {
 	struct shell_data *shell_data = static_cast<struct shell_data *>(data);
-	HomescreenHandler *homescreenHandler = shell_data->homescreenHandler;
-
-	if (!homescreenHandler)
-		return;
+	ShellEventQueue::Event event;
 
-	// a couple of use-cases, if there is no app_id in the app_list then it
-	// means this is a request to map the application, from the start to a
-	// different output that the default one. We'd get an
-	// AGL_SHELL_APP_STATE_STARTED which will handle activation.
-	//
-	// if there's an app_id then it means we might have gotten an event to
-	// move the application to another output; so we'd need to process it
-	// by explicitly calling processAppStatusEvent() which would ultimately
-	// activate the application on other output. We'd have to pick-up the
-	// last activated window and activate the default output.
-	//
-	// finally if the outputs are identical probably that's an user-error -
-	// but the compositor won't activate it again, so we don't handle that.
-	std::pair new_pending_app = std::pair(QString(app_id),
-					      QString(output_name));
-	homescreenHandler->pending_app_list.push_back(new_pending_app);
-
-	if (homescreenHandler->apps_stack.contains(QString(app_id))) {
-		qDebug() << "Gove event to move " << app_id <<
-			" to another output " << output_name;
-		homescreenHandler->processAppStatusEvent(app_id, "started");
-	}
+	event.type = ShellEventQueue::AppOnOutput;
+	event.app_id = AppIdTable::intern(app_id);
+	event.output = QString::fromUtf8(output_name);
+	shell_data->events->post(std::move(event));
 }
 
 
@@ -203,13 +165,6 @@ getWlSurface(QPlatformNativeInterface *native, QWindow *window)
 	return static_cast<struct ::wl_surface *>(surf);
 }
 
-static struct wl_output *
-getWlOutput(QPlatformNativeInterface *native, QScreen *screen)
-{
-	void *output = native->nativeResourceForScreen("output", screen);
-	return static_cast<struct ::wl_output*>(output);
-}
-
 static struct wl_display *
 getWlDisplay(QPlatformNativeInterface *native)
 {
@@ -219,19 +174,90 @@ getWlDisplay(QPlatformNativeInterface *native)
 }
 
 
+/*
+ * The QML in qml.qrc is compiled ahead of time against the Qt version we
+ * were built with. The engine validates each compiled unit by itself and
+ * recompiles from the sources, which are still bundled, when one doesn't
+ * match; check the Qt version once up front so that a mismatch shows up in
+ * the logs instead of as a slower start-up. HOMESCREEN_QML_AOT=0 forces
+ * runtime compilation.
+ */
+static void
+check_qml_cache(void)
+{
+#ifdef HOMESCREEN_QML_AOT
+	const char *aot = getenv("HOMESCREEN_QML_AOT");
+
+	if (aot && strcmp(aot, "0") == 0) {
+		qInfo() << "Ahead-of-time compiled QML disabled";
+		setenv("QML_DISABLE_DISK_CACHE", "1", 1);
+		return;
+	}
+
+	if (strcmp(qVersion(), QT_VERSION_STR) != 0) {
+		qWarning() << "QML was compiled ahead of time for Qt" << QT_VERSION_STR
+			   << "but running on Qt" << qVersion()
+			   << "- compiling QML at runtime instead";
+		setenv("QML_DISABLE_DISK_CACHE", "1", 1);
+	}
+#endif
+}
+
+/*
+ * When built with -Dresource_bundle=true the images aren't compiled into the
+ * executable but installed as an .rcc bundle, with only the SVGs
+ * compressed. Map it and register the mapping directly, so images are paged
+ * in on use and the PNGs never go through an extra inflate.
+ */
+static void
+register_resource_bundle(void)
+{
+#ifdef HOMESCREEN_RESOURCE_BUNDLE
+	const char *path = getenv("HOMESCREEN_RESOURCE_BUNDLE");
+	StartupTrace::Scope trace("register_resource_bundle");
+	// the mapping has to stay around for as long as the resources are
+	// registered, i.e. for the lifetime of the process
+	QFile *bundle = new QFile(QString::fromLocal8Bit(path ? path : HOMESCREEN_RESOURCE_BUNDLE));
+	uchar *data = nullptr;
+
+	if (bundle->open(QIODevice::ReadOnly))
+		data = bundle->map(0, bundle->size());
+
+	if (!data || !QResource::registerResource(data)) {
+		qWarning() << "Unable to register resource bundle" << bundle->fileName()
+			   << bundle->errorString();
+		delete bundle;
+		return;
+	}
+
+	qDebug() << "Mapped resource bundle" << bundle->fileName()
+		 << "of" << bundle->size() << "bytes";
+#endif
+}
+
 static void
 register_agl_shell(QPlatformNativeInterface *native, struct shell_data *shell_data)
 {
 	struct wl_display *wl;
+	struct wl_display *wrapper;
 	struct wl_registry *registry;
+	StartupTrace::Scope trace("register_agl_shell");
 
 	wl = getWlDisplay(native);
-	registry = wl_display_get_registry(wl);
 
+	// the registry has to be created on our queue: Qt reads the display
+	// from other threads, and would dispatch its globals on its own queue
+	// in between creating it and moving it. agl_shell is bound from the
+	// registry and inherits its queue.
+	wrapper = static_cast<struct wl_display *>(wl_proxy_create_wrapper(wl));
+	wl_proxy_set_queue(reinterpret_cast<struct wl_proxy *>(wrapper),
+			   shell_data->events->queue());
+	registry = wl_display_get_registry(wrapper);
+	wl_proxy_wrapper_destroy(wrapper);
 	wl_registry_add_listener(registry, &registry_listener, shell_data);
 
 	/* Roundtrip to get all globals advertised by the compositor */
-	wl_display_roundtrip(wl);
+	wl_display_roundtrip_queue(wl, shell_data->events->queue());
 	wl_registry_destroy(registry);
 }
 
@@ -239,6 +265,8 @@ static struct wl_surface *
 create_component(QPlatformNativeInterface *native, QQmlComponent *comp,
 		 QScreen *screen, QObject **qobj)
 {
+	StartupTrace::Scope trace("create_component " +
+				  comp->url().toString().toStdString());
 	QObject *obj = comp->create();
 	obj->setParent(screen);
 
@@ -250,30 +278,13 @@ create_component(QPlatformNativeInterface *native, QQmlComponent *comp,
 
 
 static void
-load_agl_shell(QPlatformNativeInterface *native, QQmlApplicationEngine *engine,
-	       struct agl_shell *agl_shell, QScreen *screen)
+set_embedded_panels_activate_region(struct agl_shell *agl_shell,
+				    struct wl_output *output, QScreen *screen)
 {
-	struct wl_surface *bg;
-	struct wl_output *output;
 	int32_t x, y;
 	int32_t width, height;
-	QObject *qobj_bg;
 	QSize size = screen->size();
 
-	// this incorporates the panels directly, but in doing so, it
-	// would also need to specify an activation area the same area
-	// in order to void overlapping any new activation window
-	QQmlComponent bg_comp(engine, QUrl("qrc:/background_with_panels.qml"));
-	qInfo() << bg_comp.errors();
-
-	bg = create_component(native, &bg_comp, screen, &qobj_bg);
-
-	output = getWlOutput(native, screen);
-
-	qDebug() << "Normal mode - with single surface";
-	qDebug() << "Setting homescreen to screen  " << screen->name();
-	agl_shell_set_background(agl_shell, bg, output);
-
 	// 216 is the width size of the panel
 	x = 0;
 	y = 216;
@@ -291,36 +302,88 @@ load_agl_shell(QPlatformNativeInterface *native, QQmlApplicationEngine *engine,
 #endif
 }
 
+static void
+init_status_bar(QObject *panel, QQmlContext *context)
+{
+	/* engine.rootObjects() works only if we had a load() */
+	StatusBarModel *statusBar = panel->findChild<StatusBarModel *>("statusBar");
+	if (statusBar) {
+		qDebug() << "got statusBar objectname, doing init()";
+		StartupTrace::Scope trace("StatusBarModel::init");
+		statusBar->init(context);
+	}
+}
+
+static void
+load_agl_shell(QPlatformNativeInterface *native, QQmlApplicationEngine *engine,
+	       struct agl_shell *agl_shell, const OutputRegistry::Output &target,
+	       ReadyTracker *tracker)
+{
+	QScreen *screen = target.screen;
+	struct wl_output *output = target.wl_output;
+	struct wl_surface *bg;
+	QObject *qobj_bg;
+
+	// this incorporates the panels directly, but in doing so, it
+	// would also need to specify an activation area the same area
+	// in order to void overlapping any new activation window
+	StartupTrace::begin("compile qrc:/background_with_panels.qml");
+	QQmlComponent bg_comp(engine, QUrl("qrc:/background_with_panels.qml"));
+	StartupTrace::end();
+	qInfo() << bg_comp.errors();
+
+	bg = create_component(native, &bg_comp, screen, &qobj_bg);
+	tracker->watch(qobject_cast<QWindow *>(qobj_bg),
+		       QStringLiteral("background_with_panels.qml"));
+
+	// the status bar is part of the embedded top panel
+	init_status_bar(qobj_bg, engine->rootContext());
+
+	qDebug() << "Normal mode - with single surface";
+	qDebug() << "Setting homescreen to screen  " << screen->name();
+	agl_shell_set_background(agl_shell, bg, output);
+
+	set_embedded_panels_activate_region(agl_shell, output, screen);
+}
+
 static void
 load_agl_shell_for_ci(QPlatformNativeInterface *native,
 		      QQmlApplicationEngine *engine,
-		      struct agl_shell *agl_shell, QScreen *screen)
+		      struct agl_shell *agl_shell, const OutputRegistry::Output &target,
+		      ReadyTracker *tracker)
 {
+	QScreen *screen = target.screen;
+	struct wl_output *output = target.wl_output;
 	struct wl_surface *bg, *top, *bottom;
-	struct wl_output *output;
 	QObject *qobj_bg, *qobj_top, *qobj_bottom;
 
+	StartupTrace::begin("compile qrc:/background_demo.qml");
 	QQmlComponent bg_comp(engine, QUrl("qrc:/background_demo.qml"));
+	StartupTrace::end();
 	qInfo() << bg_comp.errors();
 
+	StartupTrace::begin("compile qrc:/toppanel_demo.qml");
 	QQmlComponent top_comp(engine, QUrl("qrc:/toppanel_demo.qml"));
+	StartupTrace::end();
 	qInfo() << top_comp.errors();
 
+	StartupTrace::begin("compile qrc:/bottompanel_demo.qml");
 	QQmlComponent bot_comp(engine, QUrl("qrc:/bottompanel_demo.qml"));
+	StartupTrace::end();
 	qInfo() << bot_comp.errors();
 
 	top = create_component(native, &top_comp, screen, &qobj_top);
 	bottom = create_component(native, &bot_comp, screen, &qobj_bottom);
 	bg = create_component(native, &bg_comp, screen, &qobj_bg);
 
-	/* engine.rootObjects() works only if we had a load() */
-	StatusBarModel *statusBar = qobj_top->findChild<StatusBarModel *>("statusBar");
-	if (statusBar) {
-		qDebug() << "got statusBar objectname, doing init()";
-		statusBar->init(engine->rootContext());
-	}
+	tracker->watch(qobject_cast<QWindow *>(qobj_top),
+		       QStringLiteral("toppanel_demo.qml"));
+	tracker->watch(qobject_cast<QWindow *>(qobj_bottom),
+		       QStringLiteral("bottompanel_demo.qml"));
+	tracker->watch(qobject_cast<QWindow *>(qobj_bg),
+		       QStringLiteral("background_demo.qml"));
 
-	output = getWlOutput(native, screen);
+	init_status_bar(qobj_top, engine->rootContext());
 
 	qDebug() << "Setting homescreen to screen  " << screen->name();
 
@@ -331,49 +394,194 @@ load_agl_shell_for_ci(QPlatformNativeInterface *native,
 	qDebug() << "CI mode - with multiple surfaces";
 }
 
-static void
-load_agl_shell_app(QPlatformNativeInterface *native, QQmlApplicationEngine *engine,
-		   struct agl_shell *agl_shell, const char *screen_name, bool is_demo)
+static int
+ready_timeout_ms(void)
+{
+	const char *timeout = getenv("HOMESCREEN_READY_TIMEOUT_MS");
+	char *end = nullptr;
+	long val;
+
+	if (!timeout)
+		return READY_TIMEOUT_MS_DEFAULT;
+
+	val = strtol(timeout, &end, 10);
+	if (end == timeout || *end != '\0' || val < 0 || val > INT_MAX) {
+		qWarning() << "Invalid HOMESCREEN_READY_TIMEOUT_MS" << timeout;
+		return READY_TIMEOUT_MS_DEFAULT;
+	}
+
+	return val;
+}
+
+static OutputRegistry::Output
+find_target_output(OutputRegistry *outputs, const char *screen_name)
 {
-	QScreen *screen = nullptr;
+	OutputRegistry::Output output;
 
 	if (!screen_name)
-		screen = qApp->primaryScreen();
+		output = outputs->find(qApp->primaryScreen());
 	else
-		screen = find_screen(screen_name);
+		output = outputs->find(screen_name);
 
-	if (!screen) {
+	if (!output.isValid())
 		qDebug() << "No outputs present in the system.";
+
+	return output;
+}
+
+/* Delay the ready signal until all of our surfaces have been rendered at
+ * least once, which happens only in a.exec() */
+static void
+send_ready_when_presented(ReadyTracker *tracker, struct agl_shell *agl_shell)
+{
+	QObject::connect(tracker, &ReadyTracker::ready,
+			 [agl_shell, tracker](qint64 elapsed_ms, bool timed_out) {
+		if (timed_out)
+			qWarning() << "Timed out waiting for the first frame of all surfaces";
+
+		qInfo() << "sending ready to compositor, time-to-ready"
+			<< elapsed_ms << "ms";
+		StartupTrace::begin("agl_shell_ready");
+		agl_shell_ready(agl_shell);
+		StartupTrace::end();
+		StartupTrace::finish();
+
+		tracker->deleteLater();
+	});
+}
+
+static void
+load_agl_shell_app(QPlatformNativeInterface *native, QQmlApplicationEngine *engine,
+		   OutputRegistry *outputs, struct agl_shell *agl_shell,
+		   const char *screen_name, bool is_demo)
+{
+	OutputRegistry::Output target = find_target_output(outputs, screen_name);
+	ReadyTracker *tracker;
+
+	if (!target.isValid())
 		return;
+
+	tracker = new ReadyTracker(ready_timeout_ms(), qApp);
+	send_ready_when_presented(tracker, agl_shell);
+
+	if (is_demo) {
+		load_agl_shell_for_ci(native, engine, agl_shell, target, tracker);
+	} else {
+		load_agl_shell(native, engine, agl_shell, target, tracker);
 	}
 
+	tracker->arm();
+}
+
+/*
+ * Starts compiling the shell surfaces in the background, before the
+ * agl_shell interface is bound, so that both overlap.
+ */
+static ShellSurfaceLoader *
+start_agl_shell_app_async(QQmlApplicationEngine *engine, bool is_demo)
+{
+	ShellSurfaceLoader *loader = new ShellSurfaceLoader(engine, engine);
+
 	if (is_demo) {
-		load_agl_shell_for_ci(native, engine, agl_shell, screen);
+		loader->load(QUrl("qrc:/toppanel_demo.qml"), ShellSurfaceLoader::PanelTop);
+		loader->load(QUrl("qrc:/bottompanel_demo.qml"), ShellSurfaceLoader::PanelBottom);
+		loader->load(QUrl("qrc:/background_demo.qml"), ShellSurfaceLoader::Background);
 	} else {
-		load_agl_shell(native, engine, agl_shell, screen);
+		loader->load(QUrl("qrc:/background_with_panels.qml"), ShellSurfaceLoader::Background);
 	}
 
-	/* Delay the ready signal until after Qt has done all of its own setup
-	 * in a.exec() */
-	QTimer::singleShot(500, [agl_shell](){
-		qDebug() << "sending ready to compositor";
-		agl_shell_ready(agl_shell);
+	return loader;
+}
+
+/*
+ * Asynchronous counterpart of load_agl_shell() and load_agl_shell_for_ci():
+ * each surface is handed over to the compositor as soon as it has been
+ * created, instead of after all of them.
+ */
+static void
+load_agl_shell_app_async(QPlatformNativeInterface *native,
+			 QQmlApplicationEngine *engine, ShellSurfaceLoader *loader,
+			 OutputRegistry *outputs, struct agl_shell *agl_shell,
+			 const char *screen_name, bool is_demo)
+{
+	OutputRegistry::Output target = find_target_output(outputs, screen_name);
+	QScreen *screen = target.screen;
+	struct wl_output *output = target.wl_output;
+	ReadyTracker *tracker;
+
+	if (!target.isValid()) {
+		delete loader;
+		return;
+	}
+
+	tracker = new ReadyTracker(ready_timeout_ms(), qApp);
+	send_ready_when_presented(tracker, agl_shell);
+
+	qDebug() << "Setting homescreen to screen  " << screen->name()
+		 << (is_demo ? "(CI mode - with multiple surfaces)" :
+			       "(Normal mode - with single surface)");
+
+	QObject::connect(loader, &ShellSurfaceLoader::surfaceCreated, tracker,
+			 [=](QObject *obj, ShellSurfaceLoader::Role role, const QUrl &url) {
+		QWindow *win = qobject_cast<QWindow *>(obj);
+		struct wl_surface *surface;
+
+		obj->setParent(screen);
+		surface = getWlSurface(native, win);
+
+		switch (role) {
+		case ShellSurfaceLoader::Background:
+			agl_shell_set_background(agl_shell, surface, output);
+			if (!is_demo) {
+				set_embedded_panels_activate_region(agl_shell, output, screen);
+				init_status_bar(obj, engine->rootContext());
+			}
+			break;
+		case ShellSurfaceLoader::PanelTop:
+			agl_shell_set_panel(agl_shell, surface, output, AGL_SHELL_EDGE_TOP);
+			init_status_bar(obj, engine->rootContext());
+			break;
+		case ShellSurfaceLoader::PanelBottom:
+			agl_shell_set_panel(agl_shell, surface, output, AGL_SHELL_EDGE_BOTTOM);
+			break;
+		}
+
+		tracker->watch(win, url.fileName());
+	});
+
+	QObject::connect(loader, &ShellSurfaceLoader::finished, tracker, [tracker, loader]() {
+		tracker->arm();
+		loader->deleteLater();
 	});
+
+	loader->start();
 }
 
 int main(int argc, char *argv[])
 {
+	StartupTrace::init();
+
 	setenv("QT_QPA_PLATFORM", "wayland", 1);
 	setenv("QT_QUICK_CONTROLS_STYLE", "AGL", 1);
+	check_qml_cache();
 
+	StartupTrace::begin("QGuiApplication");
 	QGuiApplication app(argc, argv);
+	StartupTrace::end();
+	register_resource_bundle();
+
 	const char *screen_name;
 	bool is_demo_val = false;
 	bool is_embedded_panels = false;
-	int ret = 0;
-	struct shell_data shell_data = { nullptr, nullptr, true, false, 0 };
+	bool is_async_load = false;
+	ShellSurfaceLoader *loader = nullptr;
 
 	QPlatformNativeInterface *native = qApp->platformNativeInterface();
+	ShellEventQueue *shell_events = new ShellEventQueue(getWlDisplay(native), &app);
+	struct shell_data shell_data = { nullptr, shell_events, 0 };
+	// the dispatch thread reads the display, which goes away with app
+	QObject::connect(&app, &QCoreApplication::aboutToQuit,
+			 shell_events, &ShellEventQueue::stop);
 	screen_name = getenv("HOMESCREEN_START_SCREEN");
 
 	const char *is_demo = getenv("HOMESCREEN_DEMO_CI");
@@ -384,6 +592,10 @@ int main(int argc, char *argv[])
 	if (embedded_panels && strcmp(embedded_panels, "1") == 0)
 		is_embedded_panels = true;
 
+	const char *async_load = getenv("HOMESCREEN_ASYNC_LOAD");
+	if (async_load && strcmp(async_load, "1") == 0)
+		is_async_load = true;
+
 	QCoreApplication::setOrganizationDomain("LinuxFoundation");
 	QCoreApplication::setOrganizationName("AutomotiveGradeLinux");
 	QCoreApplication::setApplicationName("HomeScreen");
@@ -392,55 +604,93 @@ int main(int argc, char *argv[])
 	// we need to have an app_id
 	app.setDesktopFileName("homescreen");
 
+	// Import C++ class to QML
+	qmlRegisterType<StatusBarModel>("HomeScreen", 1, 0, "StatusBarModel");
+	qmlRegisterType<MasterVolume>("MasterVolume", 1, 0, "MasterVolume");
+	qmlRegisterType<VehicleSignalBinding>("HomeScreen", 1, 0, "VehicleSignal");
+
+	// has to outlive the engine
+	SvgRasterCache svg_rasters(app.devicePixelRatio());
+
+	QQmlApplicationEngine engine;
+	QQmlContext *context = engine.rootContext();
+
+	engine.addImageProvider(QStringLiteral("background"), new BackgroundImageProvider);
+	engine.addImageProvider(QStringLiteral("icons"), new IconAtlasProvider);
+	if (!svg_rasters.isEmpty())
+		engine.setUrlInterceptor(&svg_rasters);
+
+	// the last known status, shown until the services are connected
+	StartupTrace::begin("StatusSnapshot");
+	StatusSnapshot *snapshot = StatusSnapshot::instance();
+	context->setContextProperty("snapshot", snapshot);
+	StartupTrace::end();
+
+	if (is_async_load)
+		loader = start_agl_shell_app_async(&engine, is_demo_val);
+
 	register_agl_shell(native, &shell_data);
 	if (!shell_data.shell) {
 		fprintf(stderr, "agl_shell extension is not advertised. "
 			"Are you sure that agl-compositor is running?\n");
+		StartupTrace::finish();
 		exit(EXIT_FAILURE);
 	}
 
 	qDebug() << "agl-shell interface is at version " << shell_data.ver;
+	shell_events->start();
 	if (shell_data.ver >= 2) {
-		while (ret != -1 && shell_data.wait_for_bound) {
-			ret = wl_display_dispatch(getWlDisplay(native));
-
-			if (shell_data.wait_for_bound)
-				continue;
-		}
+		StartupTrace::Scope trace("wait_for_bound");
 
-		if (!shell_data.bound_ok) {
+		if (!shell_events->waitForBound()) {
 			qInfo() << "agl_shell extension already in use by other shell client.";
+			shell_events->stop();
+			StartupTrace::finish();
 			exit(EXIT_FAILURE);
 		}
 	}
 
 
-	std::shared_ptr<struct agl_shell> agl_shell{shell_data.shell, agl_shell_destroy};
-	Shell *aglShell = new Shell(agl_shell, &app);
+	OutputRegistry *outputs = new OutputRegistry(native, &app);
 
-	// Import C++ class to QML
-	qmlRegisterType<StatusBarModel>("HomeScreen", 1, 0, "StatusBarModel");
-	qmlRegisterType<MasterVolume>("MasterVolume", 1, 0, "MasterVolume");
+	std::shared_ptr<struct agl_shell> agl_shell{shell_data.shell, agl_shell_destroy};
+	Shell *aglShell = new Shell(agl_shell, outputs, &app);
 
 	ApplicationLauncher *launcher = new ApplicationLauncher();
 	launcher->setCurrent(QStringLiteral("launcher"));
 
-	HomescreenHandler* homescreenHandler = new HomescreenHandler(aglShell, launcher);
-	shell_data.homescreenHandler = homescreenHandler;
-
-	QQmlApplicationEngine engine;
-	QQmlContext *context = engine.rootContext();
+	StartupTrace::begin("HomescreenHandler");
+	HomescreenHandler* homescreenHandler = new HomescreenHandler(aglShell, outputs, launcher);
+	StartupTrace::end();
+	shell_events->setHandler(homescreenHandler);
 
 	context->setContextProperty("homescreenHandler", homescreenHandler);
 	context->setContextProperty("launcher", launcher);
-	context->setContextProperty("weather", new Weather());
+	context->setContextProperty("clock", new WallClock(&app));
+
+	StartupTrace::begin("Weather");
+	Weather *weather = new Weather();
+	QObject::connect(weather, &Weather::conditionChanged, snapshot, &StatusSnapshot::setCondition);
+	QObject::connect(weather, &Weather::temperatureChanged, snapshot, &StatusSnapshot::setTemperature);
+	context->setContextProperty("weather", weather);
+	StartupTrace::end();
+
+	StartupTrace::begin("Bluetooth");
 	context->setContextProperty("bluetooth", new Bluetooth(false, context));
+	StartupTrace::end();
 
 	// We add it here even if we don't use it
 	context->setContextProperty("shell", aglShell);
 
-	load_agl_shell_app(native, &engine, shell_data.shell,
-			   screen_name, is_demo_val);
+	if (loader)
+		load_agl_shell_app_async(native, &engine, loader, outputs,
+					 shell_data.shell, screen_name, is_demo_val);
+	else
+		load_agl_shell_app(native, &engine, outputs, shell_data.shell,
+				   screen_name, is_demo_val);
+
+	// until now SIGTERM would have waited for the event loop
+	snapshot->catchTerm();
 
 	return app.exec();
 }
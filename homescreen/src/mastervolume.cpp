@@ -15,23 +15,41 @@
  */
 
 #include "mastervolume.h"
+#include "statussnapshot.h"
 #include <QTimer>
 #include <QtDebug>
 
+#define VOLUME_PATH	"Vehicle.Cabin.Infotainment.Media.Volume"
+
 MasterVolume::MasterVolume(QObject* parent) :
 	QObject(parent),
 	m_volume(50)
 {
-	VehicleSignalsConfig vsConfig("homescreen");
-	m_vs = new VehicleSignals(vsConfig);
+	VehicleSignalHub *hub = VehicleSignalHub::instance();
 
-	if (m_vs) {
-		QObject::connect(m_vs, &VehicleSignals::connected, this, &MasterVolume::onConnected);
-		QObject::connect(m_vs, &VehicleSignals::authorized, this, &MasterVolume::onAuthorized);
-		QObject::connect(m_vs, &VehicleSignals::disconnected, this, &MasterVolume::onDisconnected);
+	// shared with every other instance, and everything else on the bus
+	m_channel = hub->acquire(VOLUME_PATH);
 
-		m_vs->connect();
-	}
+	// dragging the slider changes the volume on every step
+	m_writer = new CoalescedWriter([this](const QString &value) {
+		if (m_channel)
+			m_channel->set(value);
+	}, this);
+
+	QObject::connect(hub, &VehicleSignalHub::authorizedChanged, this, &MasterVolume::onAuthorizedChanged);
+	QObject::connect(m_channel, &VehicleSignalChannel::valueChanged, this, &MasterVolume::onValueChanged);
+
+	// the last value seen, rather than the default until the broker answers
+	if (m_channel->hasValue())
+		updateVolume(m_channel->value());
+	else if (StatusSnapshot::instance()->restored().volume >= 0)
+		m_volume = StatusSnapshot::instance()->restored().volume;
+}
+
+MasterVolume::~MasterVolume()
+{
+	if (m_channel)
+		VehicleSignalHub::instance()->release(m_channel);
 }
 
 qint32 MasterVolume::getVolume() const
@@ -45,41 +63,18 @@ void MasterVolume::setVolume(qint32 volume)
 		return;
 
 	m_volume = volume;
+	StatusSnapshot::instance()->setVolume(volume);
 
-	if (!(m_vs && m_connected))
+	if (!VehicleSignalHub::instance()->isAuthorized())
 		return;
 
-	m_vs->set("Vehicle.Cabin.Infotainment.Media.Volume", QString::number(volume));
+	m_writer->write(QString::number(volume));
 }
 
-void MasterVolume::onConnected()
+void MasterVolume::onAuthorizedChanged(bool authorized)
 {
-	if (!m_vs)
-		return;
-
-	m_vs->authorize();
-}
-
-void MasterVolume::onAuthorized()
-{
-	if (!m_vs)
-		return;
-
-	m_connected = true;
-
-	QObject::connect(m_vs, &VehicleSignals::getSuccessResponse, this, &MasterVolume::onGetSuccessResponse);
-	QObject::connect(m_vs, &VehicleSignals::signalNotification, this, &MasterVolume::onSignalNotification);
-
-	m_vs->subscribe("Vehicle.Cabin.Infotainment.Media.Volume");
-	m_vs->get("Vehicle.Cabin.Infotainment.Media.Volume");
-}
-
-void MasterVolume::onDisconnected()
-{
-	QObject::disconnect(m_vs, &VehicleSignals::signalNotification, this, &MasterVolume::onGetSuccessResponse);
-	QObject::disconnect(m_vs, &VehicleSignals::signalNotification, this, &MasterVolume::onSignalNotification);
-
-	m_connected = false;
+	if (!authorized)
+		m_writer->reset();
 }
 
 void MasterVolume::updateVolume(QString value)
@@ -88,6 +83,7 @@ void MasterVolume::updateVolume(QString value)
 	qint32 volume = value.toInt(&ok);
 	if (ok) {
 		volume = qBound(0, volume, 100);
+		StatusSnapshot::instance()->setVolume(volume);
 		if (m_volume != volume)	{
 			m_volume = volume;
 			emit VolumeChanged();
@@ -95,16 +91,9 @@ void MasterVolume::updateVolume(QString value)
 	}
 }
 
-void MasterVolume::onGetSuccessResponse(QString path, QString value, QString timestamp)
-{
-	if (path == "Vehicle.Cabin.Infotainment.Media.Volume") {
-		updateVolume(value);
-		emit VolumeChanged();
-	}
-}
-
-void MasterVolume::onSignalNotification(QString path, QString value, QString timestamp)
+void MasterVolume::onValueChanged(const QString &value)
 {
-	if (path == "Vehicle.Cabin.Infotainment.Media.Volume")
+	// our own writes coming back, which the slider may have moved past
+	if (!m_writer->acknowledge(value))
 		updateVolume(value);
 }
@@ -16,7 +16,9 @@
 
 #include <QtCore/QObject>
 #include <QQmlEngine>
-#include "vehiclesignals.h"
+#include <QPointer>
+#include "coalescedwriter.h"
+#include "vehiclesignalhub.h"
 
 class MasterVolume : public QObject
 {
@@ -25,24 +27,21 @@ class MasterVolume : public QObject
 
 private:
 	qint32 m_volume;
-	VehicleSignals *m_vs;
-	bool m_connected;
+	QPointer<VehicleSignalChannel> m_channel;
+	CoalescedWriter *m_writer;
 
 	void updateVolume(QString value);
 
 public:
 	MasterVolume(QObject* parent = nullptr);
-	~MasterVolume() = default;
+	~MasterVolume();
 
 	Q_INVOKABLE qint32 getVolume() const;
 	Q_INVOKABLE void setVolume(qint32 val);
 
 private slots:
-	void onConnected();
-	void onAuthorized();
-	void onDisconnected();
-	void onGetSuccessResponse(QString path, QString value, QString timestamp);
-	void onSignalNotification(QString path, QString value, QString timestamp);
+	void onAuthorizedChanged(bool authorized);
+	void onValueChanged(const QString &value);
 
 signals:
 	void VolumeChanged();
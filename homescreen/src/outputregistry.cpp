@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <string.h>
+
+#include "outputregistry.h"
+
+// defined by meson build file
+#include QT_QPA_HEADER
+
+OutputRegistry::OutputRegistry(QPlatformNativeInterface *native, QObject *parent) :
+	QObject(parent),
+	m_native(native)
+{
+	for (QScreen *screen : qApp->screens())
+		addScreen(screen);
+
+	connect(qApp, &QGuiApplication::screenAdded,
+		this, &OutputRegistry::addScreen);
+	connect(qApp, &QGuiApplication::screenRemoved,
+		this, &OutputRegistry::removeScreen);
+}
+
+void OutputRegistry::addScreen(QScreen *screen)
+{
+	QByteArray name = screen->name().toUtf8();
+	Output output;
+
+	output.name = screen->name();
+	output.screen = screen;
+	// no native interface outside of Wayland (replaying events)
+	if (m_native)
+		output.wl_output = static_cast<struct ::wl_output *>(
+			m_native->nativeResourceForScreen("output", screen));
+
+	m_outputs.insert(name, output);
+	m_names.insert(screen, name);
+
+	if (!m_default)
+		m_default = screen;
+}
+
+void OutputRegistry::removeScreen(QScreen *screen)
+{
+	auto it = m_names.find(screen);
+
+	if (it != m_names.end()) {
+		m_outputs.remove(it.value());
+		m_names.erase(it);
+	}
+
+	if (m_default == screen) {
+		const QList<QScreen *> screens = qApp->screens();
+		m_default = nullptr;
+		for (QScreen *s : screens)
+			if (s != screen) {
+				m_default = s;
+				break;
+			}
+	}
+}
+
+OutputRegistry::Output OutputRegistry::lookup(const QByteArray &name) const
+{
+	return m_outputs.value(name);
+}
+
+OutputRegistry::Output OutputRegistry::find(const char *name) const
+{
+	if (!name)
+		return Output();
+
+	return lookup(QByteArray::fromRawData(name, strlen(name)));
+}
+
+OutputRegistry::Output OutputRegistry::find(QScreen *screen) const
+{
+	auto it = m_names.constFind(screen);
+
+	if (it == m_names.constEnd())
+		return Output();
+
+	return lookup(it.value());
+}
+
+OutputRegistry::Output OutputRegistry::defaultOutput() const
+{
+	return find(m_default);
+}
+
+void OutputRegistry::setPendingOutput(const QString &app_id, const QByteArray &output)
+{
+	m_pending.insert(app_id, output);
+}
+
+OutputRegistry::Output OutputRegistry::pendingOutput(const QString &app_id) const
+{
+	auto it = m_pending.constFind(app_id);
+
+	if (it == m_pending.constEnd())
+		return Output();
+
+	return lookup(it.value());
+}
+
+OutputRegistry::Output OutputRegistry::takePendingOutput(const QString &app_id)
+{
+	auto it = m_pending.find(app_id);
+
+	if (it == m_pending.end())
+		return Output();
+
+	Output output = lookup(it.value());
+	m_pending.erase(it);
+	return output;
+}
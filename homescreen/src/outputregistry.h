@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OUTPUTREGISTRY_H
+#define OUTPUTREGISTRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+class QPlatformNativeInterface;
+class QScreen;
+struct wl_output;
+
+/*
+ * The outputs the homescreen knows about, by name, with their QScreen and
+ * wl_output. It follows QGuiApplication::screenAdded/screenRemoved, so
+ * lookups never go through the list of screens or the platform native
+ * interface.
+ *
+ * Names are kept as UTF-8, which is what the compositor sends, and looked
+ * up without copying the name. The registry also holds the applications
+ * the compositor asked to show on an output other than the default one
+ * (agl_shell.app_on_output), until they get activated.
+ */
+class OutputRegistry : public QObject
+{
+	Q_OBJECT
+public:
+	struct Output {
+		QString name;
+		QScreen *screen = nullptr;
+		struct wl_output *wl_output = nullptr;
+
+		bool isValid() const { return screen != nullptr; }
+	};
+
+	explicit OutputRegistry(QPlatformNativeInterface *native, QObject *parent = nullptr);
+
+	Output find(const char *name) const;
+	Output find(QScreen *screen) const;
+	QScreen *screen(const char *name) const { return find(name).screen; }
+	struct wl_output *wlOutput(QScreen *screen) const { return find(screen).wl_output; }
+
+	/* the first screen, which is where applications go by default */
+	Output defaultOutput() const;
+
+	void setPendingOutput(const QString &app_id, const QByteArray &output);
+	void setPendingOutput(const QString &app_id, const QString &output)
+	{
+		setPendingOutput(app_id, output.toUtf8());
+	}
+	/* the output app_id was routed to, if it still exists */
+	Output pendingOutput(const QString &app_id) const;
+	Output takePendingOutput(const QString &app_id);
+
+private:
+	void addScreen(QScreen *screen);
+	void removeScreen(QScreen *screen);
+	Output lookup(const QByteArray &name) const;
+
+	QPlatformNativeInterface *m_native;
+	QHash<QByteArray, Output> m_outputs;
+	QHash<QScreen *, QByteArray> m_names;
+	QScreen *m_default = nullptr;
+	QHash<QString, QByteArray> m_pending;
+};
+
+#endif // OUTPUTREGISTRY_H
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDateTime>
+#include <QSettings>
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "AppLauncherClient.h"
+#include "hmi-debug.h"
+#include "prelauncher.h"
+
+#define PRELAUNCH_IDLE_MS_DEFAULT	15000
+#define PRELAUNCH_COUNT_DEFAULT		2
+/* used for applications without a cost/<app_id> entry in the settings */
+#define PRELAUNCH_COST_MB_DEFAULT	100
+#define RECENCY_HALF_LIFE_S		(3 * 24 * 3600)
+#define SAVE_DELAY_MS			5000
+/* how long after a pre-launch its start reports are expected */
+#define PRELAUNCH_START_TIMEOUT_MS	10000
+
+static int
+env_int(const char *name, int fallback)
+{
+	const char *value = getenv(name);
+	char *end = nullptr;
+	long val;
+
+	if (!value || !*value)
+		return fallback;
+
+	val = strtol(value, &end, 10);
+	if (*end != '\0' || val < 0 || val > INT32_MAX) {
+		HMI_WARNING("HomeScreen", "Invalid %s '%s'", name, value);
+		return fallback;
+	}
+
+	return val;
+}
+
+Prelauncher::Prelauncher(AppLauncherClient *launcher, RunningFn is_running,
+			 QObject *parent) :
+	QObject(parent),
+	m_launcher(launcher),
+	m_is_running(std::move(is_running))
+{
+	m_budget_mb = env_int("HOMESCREEN_PRELAUNCH_BUDGET_MB", 0);
+	m_max_apps = env_int("HOMESCREEN_PRELAUNCH_COUNT", PRELAUNCH_COUNT_DEFAULT);
+
+	load();
+	m_clock.start();
+
+	m_idle.setSingleShot(true);
+	m_idle.setInterval(env_int("HOMESCREEN_PRELAUNCH_IDLE_MS", PRELAUNCH_IDLE_MS_DEFAULT));
+	connect(&m_idle, &QTimer::timeout, this, &Prelauncher::prelaunch);
+
+	m_save.setSingleShot(true);
+	m_save.setInterval(SAVE_DELAY_MS);
+	connect(&m_save, &QTimer::timeout, this, &Prelauncher::save);
+
+	if (enabled())
+		m_idle.start();
+}
+
+Prelauncher::~Prelauncher()
+{
+	if (m_save.isActive())
+		save();
+}
+
+void Prelauncher::load()
+{
+	QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+			   QStringLiteral("homescreen"), QStringLiteral("prelaunch"));
+
+	settings.beginGroup(QStringLiteral("stats"));
+	for (const QString &app_id : settings.childGroups()) {
+		AppStats stats;
+
+		settings.beginGroup(app_id);
+		stats.launches = settings.value(QStringLiteral("launches")).toDouble();
+		stats.last_used = settings.value(QStringLiteral("last_used")).toLongLong();
+		settings.endGroup();
+
+		m_stats.insert(app_id, stats);
+	}
+	settings.endGroup();
+
+	// estimated resident size of each application once started, in MB
+	settings.beginGroup(QStringLiteral("cost"));
+	for (const QString &app_id : settings.childKeys())
+		m_cost_mb.insert(app_id, settings.value(app_id).toInt());
+	settings.endGroup();
+}
+
+void Prelauncher::save()
+{
+	QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+			   QStringLiteral("homescreen"), QStringLiteral("prelaunch"));
+
+	settings.beginGroup(QStringLiteral("stats"));
+	for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+		settings.beginGroup(it.key());
+		settings.setValue(QStringLiteral("launches"), it->launches);
+		settings.setValue(QStringLiteral("last_used"), it->last_used);
+		settings.endGroup();
+	}
+	settings.endGroup();
+}
+
+void Prelauncher::recordActivation(const QString &app_id)
+{
+	AppStats &stats = m_stats[app_id];
+
+	stats.launches += 1;
+	stats.last_used = QDateTime::currentSecsSinceEpoch();
+
+	if (!m_save.isActive())
+		m_save.start();
+
+	noteActivity();
+}
+
+void Prelauncher::noteActivity()
+{
+	if (enabled())
+		m_idle.start();
+}
+
+bool Prelauncher::claim(const QString &app_id)
+{
+	// the start the user asked for must go through
+	m_pending_starts.remove(app_id);
+	return m_prelaunched.remove(app_id);
+}
+
+void Prelauncher::forget(const QString &app_id)
+{
+	m_prelaunched.remove(app_id);
+	m_pending_starts.remove(app_id);
+}
+
+bool Prelauncher::takePrelaunchStart(const QString &app_id, StartReport report)
+{
+	auto it = m_pending_starts.find(app_id);
+
+	if (it == m_pending_starts.end())
+		return false;
+
+	if (m_clock.elapsed() > it->deadline_ms || it->seen[report]) {
+		m_pending_starts.erase(it);
+		return false;
+	}
+
+	it->seen[report] = true;
+	if (it->seen[LauncherStart] && it->seen[ShellStart])
+		m_pending_starts.erase(it);
+
+	return true;
+}
+
+double Prelauncher::score(const AppStats &stats, qint64 now) const
+{
+	double age = qMax<qint64>(0, now - stats.last_used);
+
+	return stats.launches * exp2(-age / RECENCY_HALF_LIFE_S);
+}
+
+int Prelauncher::costMb(const QString &app_id) const
+{
+	return m_cost_mb.value(app_id, PRELAUNCH_COST_MB_DEFAULT);
+}
+
+QStringList Prelauncher::ranking() const
+{
+	qint64 now = QDateTime::currentSecsSinceEpoch();
+	QList<QPair<double, QString>> scored;
+	QStringList apps;
+
+	for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it)
+		scored.append({ score(it.value(), now), it.key() });
+
+	std::sort(scored.begin(), scored.end(),
+		  [](const QPair<double, QString> &a, const QPair<double, QString> &b) {
+		return a.first > b.first;
+	});
+
+	for (const auto &entry : scored)
+		apps << entry.second;
+
+	return apps;
+}
+
+void Prelauncher::prelaunch()
+{
+	int used_mb = 0;
+	int count = m_prelaunched.size();
+
+	for (const QString &app_id : m_prelaunched)
+		used_mb += costMb(app_id);
+
+	for (const QString &app_id : ranking()) {
+		if (count >= m_max_apps)
+			break;
+		if (m_prelaunched.contains(app_id) || m_is_running(app_id))
+			continue;
+
+		int cost = costMb(app_id);
+		if (used_mb + cost > m_budget_mb)
+			continue;
+
+		HMI_DEBUG("HomeScreen", "Pre-launching %s (%d MB of %d MB budget used)",
+			  app_id.toStdString().c_str(), used_mb + cost, m_budget_mb);
+
+		// marked first: the start events may arrive before this returns
+		m_prelaunched.insert(app_id);
+		m_pending_starts.insert(app_id, { m_clock.elapsed() + PRELAUNCH_START_TIMEOUT_MS,
+						  { false, false } });
+		if (!m_launcher->startApplication(app_id)) {
+			m_prelaunched.remove(app_id);
+			m_pending_starts.remove(app_id);
+			continue;
+		}
+
+		used_mb += cost;
+		count++;
+	}
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PRELAUNCHER_H
+#define PRELAUNCHER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <functional>
+
+class AppLauncherClient;
+
+/*
+ * Starts the applications the user is most likely to switch to next in the
+ * background, once the homescreen has been idle for a while, so that
+ * tapping their shortcut only has to activate them.
+ *
+ * Every activation feeds a per-application launch count and last-use time,
+ * kept across boots with QSettings. Applications are ranked by
+ * count x 2^(-age / half-life) and pre-launched best first, up to
+ * HOMESCREEN_PRELAUNCH_COUNT of them and as long as their estimated memory
+ * use fits in HOMESCREEN_PRELAUNCH_BUDGET_MB. Nothing is pre-launched
+ * unless a budget is set.
+ *
+ * The start reports of the pre-launch itself, one from applaunchd and one
+ * from the compositor, must not activate the application
+ * (takePrelaunchStart()); they are only expected for a few seconds after
+ * the start request, and any later start is a real one. A pre-launched
+ * application counts against the budget (isPrelaunched()) until the user
+ * switches to it (claim()) or it terminates (forget()).
+ */
+class Prelauncher : public QObject
+{
+	Q_OBJECT
+public:
+	using RunningFn = std::function<bool(const QString &app_id)>;
+
+	enum StartReport {
+		LauncherStart,	/* applaunchd "started" */
+		ShellStart,	/* AGL_SHELL_APP_STATE_STARTED */
+	};
+
+	Prelauncher(AppLauncherClient *launcher, RunningFn is_running,
+		    QObject *parent = nullptr);
+	~Prelauncher();
+
+	bool enabled() const { return m_budget_mb > 0; }
+
+	void recordActivation(const QString &app_id);
+	/* any user or application activity postpones pre-launching */
+	void noteActivity();
+
+	bool isPrelaunched(const QString &app_id) const { return m_prelaunched.contains(app_id); }
+	/* whether this start report is the pre-launch's own, to be ignored */
+	bool takePrelaunchStart(const QString &app_id, StartReport report);
+	/* the user switched to app_id; returns whether it was pre-launched */
+	bool claim(const QString &app_id);
+	void forget(const QString &app_id);
+
+	/* applications in pre-launch order, best first */
+	QStringList ranking() const;
+
+private:
+	struct AppStats {
+		double launches = 0;
+		qint64 last_used = 0;	// seconds since the epoch
+	};
+
+	double score(const AppStats &stats, qint64 now) const;
+	int costMb(const QString &app_id) const;
+	void prelaunch();
+	void load();
+	void save();
+
+	AppLauncherClient *m_launcher;
+	RunningFn m_is_running;
+	QHash<QString, AppStats> m_stats;
+	QHash<QString, int> m_cost_mb;
+	QSet<QString> m_prelaunched;
+	// start reports still expected from each pre-launch, and until when
+	struct PendingStart {
+		qint64 deadline_ms;
+		bool seen[2];
+	};
+	QHash<QString, PendingStart> m_pending_starts;
+	QElapsedTimer m_clock;
+	QTimer m_idle;
+	QTimer m_save;
+	int m_budget_mb = 0;
+	int m_max_apps;
+};
+
+#endif // PRELAUNCHER_H
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef RAWIMAGE_H
+#define RAWIMAGE_H
+
+#include <stdint.h>
+
+/*
+ * Uncompressed image format for the pre-scaled backgrounds generated at build
+ * time by tools/bgconvert. The pixels are stored exactly as QImage holds them
+ * in memory, so that the file can be mapped and used as is:
+ *
+ *   struct raw_image_header
+ *   padding up to data_offset (page aligned)
+ *   height rows of stride bytes, in native byte order
+ */
+#define RAW_IMAGE_MAGIC		0x47425348	/* "HSBG" */
+#define RAW_IMAGE_VERSION	1
+#define RAW_IMAGE_DATA_OFFSET	4096
+
+struct raw_image_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t stride;
+	uint32_t format;	/* QImage::Format */
+	uint32_t data_offset;
+	uint32_t reserved;
+};
+
+#endif // RAWIMAGE_H
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+#include <QEvent>
+#include <QQuickWindow>
+
+#include "readytracker.h"
+#include "startuptrace.h"
+
+ReadyTracker::ReadyTracker(int timeout_ms, QObject *parent) :
+	QObject(parent)
+{
+	m_elapsed.start();
+
+	m_timeout.setSingleShot(true);
+	m_timeout.setInterval(timeout_ms);
+	connect(&m_timeout, &QTimer::timeout, this, [this]() {
+		finish(true);
+	});
+}
+
+void ReadyTracker::watch(QWindow *window, const QString &name)
+{
+	if (!window || m_done)
+		return;
+
+	m_pending.insert(window, name);
+
+	// frameSwapped() is emitted from the render thread when the threaded
+	// render loop is in use, so always hop back to ours
+	QQuickWindow *quick_window = qobject_cast<QQuickWindow *>(window);
+	if (quick_window) {
+		connect(quick_window, &QQuickWindow::frameSwapped, this, [this, window]() {
+			surfacePresented(window);
+		}, Qt::QueuedConnection);
+	} else {
+		window->installEventFilter(this);
+	}
+
+	connect(window, &QObject::destroyed, this, [this, window]() {
+		surfacePresented(window);
+	});
+}
+
+void ReadyTracker::arm()
+{
+	if (m_armed)
+		return;
+
+	m_armed = true;
+	if (m_pending.isEmpty())
+		finish(false);
+	else
+		m_timeout.start();
+}
+
+bool ReadyTracker::eventFilter(QObject *obj, QEvent *event)
+{
+	if (event->type() == QEvent::Expose) {
+		QWindow *window = static_cast<QWindow *>(obj);
+		if (window->isExposed())
+			surfacePresented(window);
+	}
+
+	return QObject::eventFilter(obj, event);
+}
+
+void ReadyTracker::surfacePresented(QWindow *window)
+{
+	auto it = m_pending.find(window);
+	if (it == m_pending.end())
+		return;
+
+	StartupTrace::instant("first frame " + it.value().toStdString());
+	qDebug() << "First frame of" << it.value() << "after"
+		 << m_elapsed.elapsed() << "ms";
+
+	disconnect(window, nullptr, this, nullptr);
+	window->removeEventFilter(this);
+	m_pending.erase(it);
+
+	if (m_armed && m_pending.isEmpty())
+		finish(false);
+}
+
+void ReadyTracker::finish(bool timed_out)
+{
+	if (m_done)
+		return;
+
+	m_done = true;
+	m_timeout.stop();
+
+	if (timed_out) {
+		for (const QString &name : m_pending)
+			qWarning() << "No frame presented for" << name
+				   << "before the ready timeout";
+	}
+
+	emit ready(m_elapsed.elapsed(), timed_out);
+}
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef READYTRACKER_H
+#define READYTRACKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+
+class QWindow;
+
+/*
+ * Tracks the surfaces handed over to the compositor with
+ * agl_shell_set_background()/agl_shell_set_panel() and emits ready() once
+ * all of them have presented their first frame, or once the safety timeout
+ * expires, whichever comes first.
+ */
+class ReadyTracker : public QObject
+{
+	Q_OBJECT
+public:
+	explicit ReadyTracker(int timeout_ms, QObject *parent = nullptr);
+
+	void watch(QWindow *window, const QString &name);
+	void arm();
+
+signals:
+	// elapsed_ms is measured from the creation of the tracker
+	void ready(qint64 elapsed_ms, bool timed_out);
+
+protected:
+	bool eventFilter(QObject *obj, QEvent *event) override;
+
+private:
+	void surfacePresented(QWindow *window);
+	void finish(bool timed_out);
+
+	QHash<QWindow *, QString> m_pending;
+	QElapsedTimer m_elapsed;
+	QTimer m_timeout;
+	bool m_armed = false;
+	bool m_done = false;
+};
+
+#endif // READYTRACKER_H
@@ -26,23 +26,11 @@
 #include <QGuiApplication>
 #include <QDebug>
 #include "shell.h"
-// defined by meson build file
-#include QT_QPA_HEADER
 #include <stdio.h>
 
-static struct wl_output *
-getWlOutput(QPlatformNativeInterface *native, QScreen *screen)
-{
-	void *output = native->nativeResourceForScreen("output", screen);
-	return static_cast<struct ::wl_output*>(output);
-}
-
 void Shell::activate_app(QWindow *win, const QString &app_id)
 {
-    QPlatformNativeInterface *native = qApp->platformNativeInterface();
-    QScreen *screen = win->screen();
-
-    struct wl_output *output = getWlOutput(native, screen);
+    struct wl_output *output = m_outputs->wlOutput(win->screen());
 
     qDebug() << "++ activating app_id " << app_id.toStdString().c_str();
 
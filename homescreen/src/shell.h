@@ -33,6 +33,7 @@
 #include <QWindow>
 #include <memory>
 #include "agl-shell-client-protocol.h"
+#include "outputregistry.h"
 
 /*
  * Basic type to wrap the agl_shell wayland object into a QObject, so that it
@@ -46,14 +47,16 @@ class Shell : public QObject
 public:
 	std::shared_ptr<struct agl_shell> shell;
 
-	Shell(std::shared_ptr<struct agl_shell> shell, QObject *parent = nullptr) :
-		QObject(parent), shell(shell)
+	Shell(std::shared_ptr<struct agl_shell> shell, OutputRegistry *outputs,
+	      QObject *parent = nullptr) :
+		QObject(parent), shell(shell), m_outputs(outputs)
 	{}
 	public slots:
 		void activate_app(QWindow *win, const QString &app_id);
 	void set_activate_region(struct wl_output *output, int32_t x, int32_t y,
 			int32_t width, int32_t height);
 private:
+	OutputRegistry *m_outputs;
 	struct wl_region *m_region = nullptr;
 };
 
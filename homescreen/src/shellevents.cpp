@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <wayland-client.h>
+
+#include "shellevents.h"
+#include "homescreenhandler.h"
+
+ShellEventQueue::ShellEventQueue(struct wl_display *display, QObject *parent) :
+	QObject(parent),
+	m_display(display)
+{
+	m_queue = wl_display_create_queue(display);
+	m_stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+/*
+ * The queue itself is left to go away with the display: the agl_shell
+ * proxy on it is still alive at this point, held by Shell.
+ */
+ShellEventQueue::~ShellEventQueue()
+{
+	stop();
+	if (m_stop_fd >= 0)
+		close(m_stop_fd);
+}
+
+void ShellEventQueue::start()
+{
+	if (m_thread.joinable())
+		return;
+
+	m_thread = std::thread(&ShellEventQueue::run, this);
+}
+
+void ShellEventQueue::stop()
+{
+	uint64_t one = 1;
+
+	if (!m_thread.joinable())
+		return;
+
+	if (write(m_stop_fd, &one, sizeof(one)) < 0)
+		qWarning() << "Unable to stop the agl_shell dispatch thread:" << strerror(errno);
+	m_thread.join();
+}
+
+void ShellEventQueue::run()
+{
+	struct pollfd fds[2] = {
+		{ wl_display_get_fd(m_display), POLLIN, 0 },
+		{ m_stop_fd, POLLIN, 0 },
+	};
+
+	for (;;) {
+		while (wl_display_prepare_read_queue(m_display, m_queue) != 0)
+			wl_display_dispatch_queue_pending(m_display, m_queue);
+		wl_display_flush(m_display);
+
+		if (poll(fds, 2, -1) < 0) {
+			wl_display_cancel_read(m_display);
+			if (errno == EINTR)
+				continue;
+			qWarning() << "agl_shell dispatch thread:" << strerror(errno);
+			break;
+		}
+
+		if (fds[1].revents) {
+			wl_display_cancel_read(m_display);
+			break;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			if (wl_display_read_events(m_display) < 0) {
+				qWarning() << "agl_shell dispatch thread: lost the display";
+				break;
+			}
+		} else {
+			wl_display_cancel_read(m_display);
+		}
+
+		wl_display_dispatch_queue_pending(m_display, m_queue);
+	}
+
+	// unblock waitForBound() if we never got there
+	setBound(false);
+}
+
+void ShellEventQueue::setBound(bool ok)
+{
+	std::lock_guard<std::mutex> guard(m_bound_lock);
+
+	if (m_bound_known)
+		return;
+
+	m_bound_known = true;
+	m_bound_ok = ok;
+	m_bound_cond.notify_all();
+}
+
+bool ShellEventQueue::waitForBound()
+{
+	std::unique_lock<std::mutex> guard(m_bound_lock);
+
+	m_bound_cond.wait(guard, [this]() { return m_bound_known; });
+	return m_bound_ok;
+}
+
+void ShellEventQueue::post(Event &&event)
+{
+	// never drop protocol events; the GUI thread always catches up
+	while (!m_events.push_with([&event](Event &slot) { slot = std::move(event); }))
+		std::this_thread::yield();
+
+	if (!m_drain_scheduled.exchange(true))
+		QMetaObject::invokeMethod(this, &ShellEventQueue::drain, Qt::QueuedConnection);
+}
+
+void ShellEventQueue::setHandler(HomescreenHandler *handler)
+{
+	m_handler = handler;
+
+	if (!m_drain_scheduled.exchange(true))
+		QMetaObject::invokeMethod(this, &ShellEventQueue::drain, Qt::QueuedConnection);
+}
+
+void ShellEventQueue::drain()
+{
+	Event event;
+
+	m_drain_scheduled = false;
+
+	if (!m_handler)
+		return;
+
+	while (m_events.pop(event)) {
+		switch (event.type) {
+		case AppState:
+			m_handler->processShellAppState(event.app_id, event.state);
+			break;
+		case AppOnOutput:
+			m_handler->processAppOnOutput(event.app_id, event.output);
+			break;
+		}
+	}
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SHELLEVENTS_H
+#define SHELLEVENTS_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "appid.h"
+#include "boundedqueue.h"
+
+struct wl_display;
+struct wl_event_queue;
+class HomescreenHandler;
+
+/*
+ * Dispatches the agl_shell proxy on a wl_event_queue of its own, from a
+ * thread of its own, so that protocol events are read and acknowledged
+ * while the GUI thread is busy compiling QML or rendering.
+ *
+ * The listener callbacks run on the dispatch thread; they only post typed
+ * events, which reach HomescreenHandler on the GUI thread through a
+ * lock-free queue. Events that arrive before the handler exists are kept
+ * until it is set.
+ */
+class ShellEventQueue : public QObject
+{
+	Q_OBJECT
+public:
+	enum Type {
+		AppState,
+		AppOnOutput,
+	};
+
+	struct Event {
+		Type type = AppState;
+		uint32_t state = 0;
+		AppId app_id = 0;
+		QString output;
+	};
+
+	explicit ShellEventQueue(struct wl_display *display, QObject *parent = nullptr);
+	~ShellEventQueue();
+
+	/* proxies created from a proxy on this queue end up on it as well */
+	struct wl_event_queue *queue() const { return m_queue; }
+
+	void start();
+	void stop();
+
+	/* agl_shell.bound_ok/bound_fail, from whichever thread dispatched it */
+	void setBound(bool ok);
+	/* blocks until the compositor answered the bind */
+	bool waitForBound();
+
+	/* dispatch thread */
+	void post(Event &&event);
+
+	/* GUI thread */
+	void setHandler(HomescreenHandler *handler);
+
+private:
+	void run();
+	void drain();
+
+	struct wl_display *m_display;
+	struct wl_event_queue *m_queue;
+	std::thread m_thread;
+	int m_stop_fd = -1;
+
+	BoundedQueue<Event, 1024> m_events;
+	std::atomic<bool> m_drain_scheduled{false};
+	HomescreenHandler *m_handler = nullptr;
+
+	std::mutex m_bound_lock;
+	std::condition_variable m_bound_cond;
+	bool m_bound_known = false;
+	bool m_bound_ok = false;
+};
+
+#endif // SHELLEVENTS_H
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+#include <QTimerEvent>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+
+#include "shellloader.h"
+#include "startuptrace.h"
+
+// how long each event loop iteration spends on incubation; short enough to
+// leave room for the loader thread's completion events and for rendering
+#define INCUBATION_SLICE_MS	5
+
+class ShellSurfaceLoader::Incubator : public QQmlIncubator
+{
+public:
+	Incubator(ShellSurfaceLoader *loader, Surface *surface) :
+		QQmlIncubator(QQmlIncubator::Asynchronous),
+		m_loader(loader), m_surface(surface)
+	{}
+
+protected:
+	void statusChanged(Status status) override
+	{
+		m_loader->incubatorStatusChanged(m_surface, status);
+	}
+
+private:
+	ShellSurfaceLoader *m_loader;
+	Surface *m_surface;
+};
+
+struct ShellSurfaceLoader::Surface {
+	QUrl url;
+	Role role;
+	QQmlComponent *component = nullptr;
+	Incubator *incubator = nullptr;
+	bool done = false;
+};
+
+ShellSurfaceLoader::ShellSurfaceLoader(QQmlEngine *engine, QObject *parent) :
+	QObject(parent), m_engine(engine)
+{
+	if (!m_engine->incubationController())
+		m_engine->setIncubationController(this);
+	else
+		qWarning() << "Engine already has an incubation controller";
+}
+
+ShellSurfaceLoader::~ShellSurfaceLoader()
+{
+	if (m_engine->incubationController() == this)
+		m_engine->setIncubationController(nullptr);
+
+	for (Surface *surface : m_surfaces) {
+		delete surface->incubator;
+		delete surface;
+	}
+}
+
+void ShellSurfaceLoader::load(const QUrl &url, Role role)
+{
+	Surface *surface = new Surface;
+
+	surface->url = url;
+	surface->role = role;
+	surface->component = new QQmlComponent(m_engine, this);
+
+	m_surfaces.append(surface);
+	m_pending++;
+
+	connect(surface->component, &QQmlComponent::statusChanged, this, [this, surface]() {
+		componentStatusChanged(surface);
+	});
+
+	StartupTrace::instant("compile " + url.toString().toStdString());
+	surface->component->loadUrl(url, QQmlComponent::Asynchronous);
+}
+
+void ShellSurfaceLoader::start()
+{
+	m_started = true;
+
+	// components may have finished compiling, or failed, in the meantime
+	for (Surface *surface : m_surfaces)
+		componentStatusChanged(surface);
+
+	if (m_pending == 0)
+		emit finished();
+}
+
+void ShellSurfaceLoader::componentStatusChanged(Surface *surface)
+{
+	QQmlComponent *component = surface->component;
+
+	if (surface->done || surface->incubator || component->isLoading())
+		return;
+
+	if (component->isError()) {
+		qWarning() << "Failed to load" << surface->url << component->errors();
+		surfaceDone(surface);
+		return;
+	}
+
+	if (component->isReady() && m_started)
+		incubate(surface);
+}
+
+void ShellSurfaceLoader::incubate(Surface *surface)
+{
+	StartupTrace::instant("incubate " + surface->url.toString().toStdString());
+
+	surface->incubator = new Incubator(this, surface);
+	surface->component->create(*surface->incubator);
+}
+
+void ShellSurfaceLoader::incubatorStatusChanged(Surface *surface, QQmlIncubator::Status status)
+{
+	switch (status) {
+	case QQmlIncubator::Ready:
+		StartupTrace::instant("created " + surface->url.toString().toStdString());
+		emit surfaceCreated(surface->incubator->object(), surface->role,
+				    surface->url);
+		surfaceDone(surface);
+		break;
+	case QQmlIncubator::Error:
+		qWarning() << "Failed to create" << surface->url
+			   << surface->incubator->errors();
+		surfaceDone(surface);
+		break;
+	default:
+		break;
+	}
+}
+
+void ShellSurfaceLoader::surfaceDone(Surface *surface)
+{
+	if (surface->done)
+		return;
+
+	surface->done = true;
+	if (--m_pending == 0 && m_started)
+		emit finished();
+}
+
+void ShellSurfaceLoader::incubatingObjectCountChanged(int count)
+{
+	if (count > 0 && !m_timer) {
+		m_timer = startTimer(0);
+	} else if (count == 0 && m_timer) {
+		killTimer(m_timer);
+		m_timer = 0;
+	}
+}
+
+void ShellSurfaceLoader::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_timer)
+		return QObject::timerEvent(event);
+
+	incubateFor(INCUBATION_SLICE_MS);
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SHELLLOADER_H
+#define SHELLLOADER_H
+
+#include <QObject>
+#include <QList>
+#include <QUrl>
+#include <QtQml/QQmlIncubator>
+
+class QQmlComponent;
+class QQmlEngine;
+
+/*
+ * Loads the shell surfaces (background, panels) asynchronously.
+ *
+ * Components are compiled by the engine's loader thread as soon as load()
+ * is called, which lets compilation overlap with the agl_shell bind. Once
+ * start() is called, each of them is instantiated through a QQmlIncubator
+ * driven from the event loop, so all surfaces make progress at the same
+ * time and surfaceCreated() is emitted for each as soon as it is complete.
+ */
+class ShellSurfaceLoader : public QObject, public QQmlIncubationController
+{
+	Q_OBJECT
+public:
+	enum Role {
+		Background,
+		PanelTop,
+		PanelBottom,
+	};
+	Q_ENUM(Role)
+
+	explicit ShellSurfaceLoader(QQmlEngine *engine, QObject *parent = nullptr);
+	~ShellSurfaceLoader();
+
+	void load(const QUrl &url, Role role);
+	void start();
+
+signals:
+	void surfaceCreated(QObject *object, ShellSurfaceLoader::Role role,
+			    const QUrl &url);
+	void finished();
+
+protected:
+	void incubatingObjectCountChanged(int count) override;
+	void timerEvent(QTimerEvent *event) override;
+
+private:
+	struct Surface;
+	class Incubator;
+
+	void componentStatusChanged(Surface *surface);
+	void incubate(Surface *surface);
+	void incubatorStatusChanged(Surface *surface, QQmlIncubator::Status status);
+	void surfaceDone(Surface *surface);
+
+	QQmlEngine *m_engine;
+	QList<Surface *> m_surfaces;
+	int m_pending = 0;
+	int m_timer = 0;
+	bool m_started = false;
+};
+
+#endif // SHELLLOADER_H
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "signalnotifier.h"
+
+/* per signal number: the end written from the handler, and the one read */
+static int signal_fds[NSIG][2];
+static bool signal_fds_init = false;
+
+static void
+signal_handler(int signum)
+{
+	char c = 1;
+	int saved_errno = errno;
+
+	if (write(signal_fds[signum][0], &c, 1) < 0) {
+		/* nothing we can do from here */
+	}
+	errno = saved_errno;
+}
+
+SignalNotifier::SignalNotifier(int signum, QObject *parent) :
+	QObject(parent),
+	m_signum(signum)
+{
+	struct sigaction sa = {};
+
+	if (!signal_fds_init) {
+		for (int s = 0; s < NSIG; s++)
+			signal_fds[s][0] = signal_fds[s][1] = -1;
+		signal_fds_init = true;
+	}
+
+	if (signal_fds[signum][0] >= 0) {
+		qWarning() << "Signal" << signum << "is already caught";
+		return;
+	}
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+		       0, signal_fds[signum]) < 0) {
+		qWarning() << "Unable to catch" << strsignal(signum) << ":" << strerror(errno);
+		return;
+	}
+
+	m_notifier = new QSocketNotifier(signal_fds[signum][1], QSocketNotifier::Read, this);
+	connect(m_notifier, &QSocketNotifier::activated,
+		this, &SignalNotifier::readSignals);
+
+	sa.sa_handler = signal_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_RESTART;
+	sigaction(signum, &sa, nullptr);
+}
+
+SignalNotifier::~SignalNotifier()
+{
+	if (!m_notifier)
+		return;
+
+	signal(m_signum, SIG_DFL);
+	close(signal_fds[m_signum][0]);
+	close(signal_fds[m_signum][1]);
+	signal_fds[m_signum][0] = signal_fds[m_signum][1] = -1;
+}
+
+void SignalNotifier::readSignals()
+{
+	char buf[16];
+
+	while (read(signal_fds[m_signum][1], buf, sizeof(buf)) > 0)
+		;
+
+	emit activated();
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SIGNALNOTIFIER_H
+#define SIGNALNOTIFIER_H
+
+#include <QObject>
+
+class QSocketNotifier;
+
+/*
+ * Turns a Unix signal into a Qt signal, delivered from the event loop: the
+ * handler only writes to a socketpair, which a QSocketNotifier watches. The
+ * signal goes back to its default disposition when the notifier is
+ * destroyed. One notifier per signal number.
+ */
+class SignalNotifier : public QObject
+{
+	Q_OBJECT
+public:
+	explicit SignalNotifier(int signum, QObject *parent = nullptr);
+	~SignalNotifier();
+
+signals:
+	/* once for any number of signals received since the last time */
+	void activated();
+
+private:
+	void readSignals();
+
+	int m_signum;
+	QSocketNotifier *m_notifier = nullptr;
+};
+
+#endif // SIGNALNOTIFIER_H
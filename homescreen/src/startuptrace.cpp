@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "startuptrace.h"
+
+struct trace_event {
+	std::string name;
+	char phase;		/* 'X' complete, 'i' instant */
+	uint64_t ts;		/* usec, CLOCK_MONOTONIC */
+	uint64_t dur;
+	long tid;
+};
+
+struct trace_state {
+	std::mutex lock;
+	std::atomic<bool> enabled{false};
+	std::string path;
+	std::vector<trace_event> events;
+	/* indices into events of the phases that are still open */
+	std::vector<size_t> open;
+};
+
+static trace_state &
+state()
+{
+	static trace_state s;
+	return s;
+}
+
+static uint64_t
+now_usec()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static long
+current_tid()
+{
+	return syscall(SYS_gettid);
+}
+
+static void
+write_json_string(FILE *f, const std::string &str)
+{
+	fputc('"', f);
+	for (char c : str) {
+		if (c == '"' || c == '\\')
+			fprintf(f, "\\%c", c);
+		else if ((unsigned char) c < 0x20)
+			fprintf(f, "\\u%04x", c);
+		else
+			fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+void StartupTrace::init()
+{
+	trace_state &s = state();
+	const char *path = getenv("HOMESCREEN_STARTUP_TRACE");
+
+	if (!path || !*path)
+		return;
+
+	std::lock_guard<std::mutex> guard(s.lock);
+	s.enabled = true;
+	s.path = path;
+	s.events.reserve(64);
+	s.events.push_back({ "main", 'i', now_usec(), 0, current_tid() });
+}
+
+bool StartupTrace::enabled()
+{
+	return state().enabled;
+}
+
+void StartupTrace::begin(const std::string &name)
+{
+	trace_state &s = state();
+
+	if (!s.enabled)
+		return;
+
+	std::lock_guard<std::mutex> guard(s.lock);
+	s.open.push_back(s.events.size());
+	s.events.push_back({ name, 'X', now_usec(), 0, current_tid() });
+}
+
+void StartupTrace::end()
+{
+	trace_state &s = state();
+	uint64_t ts = now_usec();
+
+	if (!s.enabled)
+		return;
+
+	std::lock_guard<std::mutex> guard(s.lock);
+	if (s.open.empty())
+		return;
+
+	trace_event &ev = s.events[s.open.back()];
+	ev.dur = ts - ev.ts;
+	s.open.pop_back();
+}
+
+void StartupTrace::instant(const std::string &name)
+{
+	trace_state &s = state();
+
+	if (!s.enabled)
+		return;
+
+	std::lock_guard<std::mutex> guard(s.lock);
+	s.events.push_back({ name, 'i', now_usec(), 0, current_tid() });
+}
+
+/*
+ * Writes the trace out and stops recording; phases that are still open at
+ * this point are closed at the time of the call.
+ */
+void StartupTrace::finish()
+{
+	trace_state &s = state();
+	uint64_t ts = now_usec();
+	bool to_stderr;
+	FILE *f;
+
+	if (!s.enabled)
+		return;
+
+	std::lock_guard<std::mutex> guard(s.lock);
+	s.enabled = false;
+
+	for (size_t idx : s.open)
+		s.events[idx].dur = ts - s.events[idx].ts;
+	s.open.clear();
+
+	to_stderr = s.path == "-" || s.path == "stderr";
+	f = to_stderr ? stderr : fopen(s.path.c_str(), "w");
+	if (!f) {
+		fprintf(stderr, "Unable to write startup trace to %s: %s\n",
+			s.path.c_str(), strerror(errno));
+		return;
+	}
+
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"args\":{\"name\":\"homescreen\"}}", getpid());
+
+	for (const trace_event &ev : s.events) {
+		fprintf(f, ",\n{\"name\":");
+		write_json_string(f, ev.name);
+		fprintf(f, ",\"cat\":\"startup\",\"ph\":\"%c\",\"ts\":%llu,"
+			"\"pid\":%d,\"tid\":%ld",
+			ev.phase, (unsigned long long) ev.ts, getpid(), ev.tid);
+		if (ev.phase == 'X')
+			fprintf(f, ",\"dur\":%llu", (unsigned long long) ev.dur);
+		else
+			fprintf(f, ",\"s\":\"p\"");
+		fputc('}', f);
+	}
+	fprintf(f, "\n]}\n");
+
+	if (to_stderr)
+		fflush(f);
+	else
+		fclose(f);
+
+	s.events.clear();
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <string>
+
+/*
+ * Records the phases between main() and agl_shell_ready() and writes them
+ * out as a Chrome trace JSON file, which can be loaded in chrome://tracing
+ * or ui.perfetto.dev.
+ *
+ * Tracing is enabled by setting HOMESCREEN_STARTUP_TRACE to a file path, or
+ * to "-" (or "stderr") to write the trace to stderr. Nothing is recorded
+ * when the variable is not set. The trace is written out once, by finish().
+ */
+class StartupTrace
+{
+public:
+	static void init();
+	static bool enabled();
+
+	static void begin(const std::string &name);
+	static void end();
+	static void instant(const std::string &name);
+	static void finish();
+
+	/* Traces the lifetime of the enclosing block as a single phase. */
+	class Scope
+	{
+	public:
+		explicit Scope(const std::string &name) :
+			m_active(StartupTrace::enabled())
+		{
+			if (m_active)
+				StartupTrace::begin(name);
+		}
+
+		~Scope()
+		{
+			if (m_active)
+				StartupTrace::end();
+		}
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		bool m_active;
+	};
+};
+
+#endif // STARTUPTRACE_H
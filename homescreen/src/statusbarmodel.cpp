@@ -17,9 +17,16 @@
 
 #include "statusbarmodel.h"
 #include "statusbarserver.h"
+#include "statusindicators.h"
+#include "statussnapshot.h"
+#include <QtCore/QTimer>
+#include <bluetooth.h>
 #include <network.h>
 #include <wifiadapter.h>
 
+// how long the restored status may stand in for services that don't report
+#define SNAPSHOT_GRACE_MS   10000
+
 class StatusBarModel::Private
 {
 public:
@@ -28,30 +35,37 @@ public:
 private:
     StatusBarModel *q;
 public:
-    StatusBarServer server;
-    QString iconList[StatusBarServer::SupportedCount];
+    StatusIndicators indicators;
     Network *network;
     WifiAdapter *wifi_a;
+    Bluetooth *bluetooth;
+    StatusBarServer *server;
+    int first_slot_row;
 };
 
 StatusBarModel::Private::Private(StatusBarModel *parent)
     : q(parent)
+    , network(nullptr)
+    , wifi_a(nullptr)
+    , bluetooth(nullptr)
+    , server(nullptr)
+    , first_slot_row(StatusIndicators::BuiltinCount)
 {
-    connect(&server, &StatusBarServer::statusIconChanged, [&](int placeholderIndex, const QString &icon) {
-        if (placeholderIndex < 0 || StatusBarServer::SupportedCount <= placeholderIndex) return;
-        if (iconList[placeholderIndex] == icon) return;
-        iconList[placeholderIndex] = icon;
-        emit q->dataChanged(q->index(placeholderIndex), q->index(placeholderIndex));
-    });
-    for (int i = 0; i < StatusBarServer::SupportedCount; i++) {
-        iconList[i] = server.getStatusIcon(i);
-    }
 }
 
 StatusBarModel::StatusBarModel(QObject *parent)
     : QAbstractListModel(parent)
     , d(new Private(this))
 {
+    StatusSnapshot *snapshot = StatusSnapshot::instance();
+
+    // created along with the QML, so this is what the first frame shows
+    if (snapshot->valid()) {
+        const StatusSnapshot::Values &values = snapshot->restored();
+
+        d->indicators.set(StatusIndicators::Wifi, values.wifi_available, values.wifi_strength);
+        d->indicators.set(StatusIndicators::Bluetooth, values.bluetooth_power);
+    }
 }
 
 StatusBarModel::~StatusBarModel()
@@ -61,6 +75,9 @@ StatusBarModel::~StatusBarModel()
 
 void StatusBarModel::init(QQmlContext *context)
 {
+    if (d->network)
+        return;
+
     d->network = new Network(false, context);
     context->setContextProperty("network", d->network);
     d->wifi_a = static_cast<WifiAdapter*>(d->network->findAdapter("wifi"));
@@ -73,22 +90,65 @@ void StatusBarModel::init(QQmlContext *context)
     QObject::connect(d->wifi_a, &WifiAdapter::wifiStrengthChanged,
 		     this, &StatusBarModel::onWifiStrengthChanged);
 
+    // created by main() along with the other services
+    d->bluetooth = qobject_cast<Bluetooth *>(context->contextProperty("bluetooth").value<QObject *>());
+    if (d->bluetooth)
+        QObject::connect(d->bluetooth, &Bluetooth::powerChanged,
+                         this, &StatusBarModel::onBluetoothPowerChanged);
+
+    // the services only know their state once connected, until then the
+    // snapshot is closer to the truth than their defaults
+    if (StatusSnapshot::instance()->valid())
+        QTimer::singleShot(SNAPSHOT_GRACE_MS, this, &StatusBarModel::syncServices);
+    else
+        syncServices();
+
+    // the rest comes from the status providers, after the built-in rows
+    d->server = new StatusBarServer(this);
+    d->server->loadProviders();
+
+    // the status bar always had a cellular icon, keep it without a modem
+    bool has_cellular = false;
+    for (int slot = 0; slot < d->server->count(); ++slot)
+        if (d->server->indicator(slot).name == QLatin1String("cellular"))
+            has_cellular = true;
+
+    int first = d->indicators.count();
+    int added = d->server->count() + (has_cellular ? 0 : 1);
+    if (added > 0) {
+        beginInsertRows(QModelIndex(), first, first + added - 1);
+        if (!has_cellular) {
+            // never set available, so only its off icon shows
+            d->indicators.add(StatusIndicators::cellular());
+        }
+        d->first_slot_row = d->indicators.count();
+        for (int slot = 0; slot < d->server->count(); ++slot)
+            d->indicators.add(d->server->indicator(slot));
+        endInsertRows();
+    }
+
+    QObject::connect(d->server, &StatusBarServer::slotsChanged,
+                     this, &StatusBarModel::onSlotsChanged);
+    d->server->start();
+}
+
+void StatusBarModel::indicatorChanged(int row)
+{
+    emit dataChanged(index(row), index(row));
+}
+
+void StatusBarModel::syncServices()
+{
     setWifiStatus(d->wifi_a->wifiConnected(), d->wifi_a->wifiEnabled(), d->wifi_a->wifiStrength());
+    if (d->bluetooth)
+        onBluetoothPowerChanged(d->bluetooth->power());
 }
 
 void StatusBarModel::setWifiStatus(bool connected, bool enabled, int strength)
 {
-    if (enabled && connected)
-        if (strength < 30)
-            d->server.setStatusIcon(0, QStringLiteral("qrc:/images/Status/HMI_Status_Wifi_1Bar-01.png"));
-        else if (strength < 50)
-            d->server.setStatusIcon(0, QStringLiteral("qrc:/images/Status/HMI_Status_Wifi_2Bars-01.png"));
-        else if (strength < 70)
-            d->server.setStatusIcon(0, QStringLiteral("qrc:/images/Status/HMI_Status_Wifi_3Bars-01.png"));
-        else
-            d->server.setStatusIcon(0, QStringLiteral("qrc:/images/Status/HMI_Status_Wifi_Full-01.png"));
-    else
-        d->server.setStatusIcon(0, QStringLiteral("qrc:/images/Status/HMI_Status_Wifi_NoBars-01.png"));
+    StatusSnapshot::instance()->setWifi(enabled && connected, strength);
+    if (d->indicators.set(StatusIndicators::Wifi, enabled && connected, strength))
+        indicatorChanged(StatusIndicators::Wifi);
 }
 
 void StatusBarModel::onWifiConnectedChanged(bool connected)
@@ -103,32 +163,58 @@ void StatusBarModel::onWifiEnabledChanged(bool enabled)
 
 void StatusBarModel::onWifiStrengthChanged(int strength)
 {
-    qInfo() << "Strength changed: " << strength;
     setWifiStatus(d->wifi_a->wifiConnected(), d->wifi_a->wifiEnabled(), strength);
 }
 
+void StatusBarModel::onBluetoothPowerChanged(bool powered)
+{
+    StatusSnapshot::instance()->setBluetoothPower(powered);
+    if (d->indicators.set(StatusIndicators::Bluetooth, powered))
+        indicatorChanged(StatusIndicators::Bluetooth);
+}
+
+void StatusBarModel::onSlotsChanged(quint64 slots)
+{
+    int first = -1, last = -1;
+
+    // one dataChanged for the whole batch
+    for (int slot = 0; slot < d->server->count(); ++slot) {
+        int row = d->first_slot_row + slot;
+
+        if (!(slots & (quint64(1) << slot)))
+            continue;
+        if (!d->indicators.set(row, d->server->available(slot), d->server->level(slot)))
+            continue;
+
+        if (first < 0)
+            first = row;
+        last = row;
+    }
+
+    if (first >= 0)
+        emit dataChanged(index(first), index(last));
+}
+
 int StatusBarModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
 
-    // Delete bluetooth because use agl-service-bluetooth.
-    return StatusBarServer::SupportedCount - 1;
+    return d->indicators.count();
 }
 
 QVariant StatusBarModel::data(const QModelIndex &index, int role) const
 {
     QVariant ret;
-    if (!index.isValid())
+    if (!index.isValid() || index.row() >= d->indicators.count())
         return ret;
 
     switch (role) {
-    case Qt::DisplayRole:
-        if (index.row() == 0){
-            ret = d->iconList[StatusBarServer::StatusWifi];
-        }else if (index.row() == 1){
-            ret = d->iconList[StatusBarServer::StatusCellular];
-        }
+    case IconRole:
+        ret = d->indicators.icon(index.row());
+        break;
+    case TextRole:
+        ret = d->indicators.text(index.row());
         break;
     default:
         break;
@@ -140,6 +226,7 @@ QVariant StatusBarModel::data(const QModelIndex &index, int role) const
 QHash<int, QByteArray> StatusBarModel::roleNames() const
 {
     QHash<int, QByteArray> roles;
-    roles[Qt::DisplayRole] = "icon";
+    roles[IconRole] = "icon";
+    roles[TextRole] = "text";
     return roles;
 }
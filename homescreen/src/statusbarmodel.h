@@ -24,6 +24,11 @@ class StatusBarModel : public QAbstractListModel
 {
     Q_OBJECT
 public:
+    enum Roles {
+        IconRole = Qt::DisplayRole,
+        TextRole = Qt::UserRole,
+    };
+
     explicit StatusBarModel(QObject *parent = NULL);
     ~StatusBarModel();
 
@@ -37,11 +42,15 @@ public:
     void onWifiConnectedChanged(bool connected);
     void onWifiEnabledChanged(bool enabled);
     void onWifiStrengthChanged(int strength);
+    void onBluetoothPowerChanged(bool powered);
+    void onSlotsChanged(quint64 slots);
 
 private:
     class Private;
     Private *d;
     void setWifiStatus(bool connected, bool enabled, int strength);
+    void syncServices();
+    void indicatorChanged(int row);
 };
 
 #endif // STATUSBARMODEL_H
@@ -16,73 +16,235 @@
  */
 
 #include "statusbarserver.h"
+#include "statusprovider.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtCore/qalgorithms.h>
+
+#include <atomic>
+#include <stdlib.h>
+
+// drains are paced to a frame
+#define FRAME_MS    16
+
+#ifdef HAVE_QT_DBUS
+#define DEFAULT_PROVIDERS   "cellular"
+#else
+#define DEFAULT_PROVIDERS   ""
+#endif
+
+// whether the indicator is available in the upper half, the level below
+static quint64 pack(bool available, int level)
+{
+    return (quint64(available) << 32) | quint32(level);
+}
 
 class StatusBarServer::Private
 {
 public:
-    Private(StatusBarServer *parent);
-    QString texts[SupportedCount];
-    QString icons[SupportedCount];
+    Private();
+
+    QVector<StatusProvider *> providers;
+    QVector<QThread *> threads;
+
+    // written by the providers
+    std::atomic<quint64> values[MaxSlots];
+    std::atomic<quint64> dirty;
+    std::atomic<bool> drain_scheduled;
+
+    // GUI thread
+    quint64 current[MaxSlots];
+    QTimer frame;
+    QElapsedTimer since_drain;
 };
 
-StatusBarServer::Private::Private(StatusBarServer *parent)
+StatusBarServer::Private::Private()
+    : dirty(0)
+    , drain_scheduled(false)
 {
-    icons[0] = QStringLiteral("qrc:/images/Status/HMI_Status_Wifi_NoBars-01.png");
-    icons[1] = QStringLiteral("qrc:/images/Status/HMI_Status_Bluetooth_Inactive-01.png");
-    icons[2] = QStringLiteral("qrc:/images/Status/HMI_Status_Signal_NoBars-01.png");
+    for (int i = 0; i < MaxSlots; ++i) {
+        values[i] = pack(false, 0);
+        current[i] = pack(false, 0);
+    }
+
+    frame.setSingleShot(true);
+    frame.setTimerType(Qt::PreciseTimer);
+    since_drain.start();
 }
 
 StatusBarServer::StatusBarServer(QObject *parent)
     : QObject(parent)
-    , d(new Private(this))
+    , d(new Private)
 {
+    connect(&d->frame, &QTimer::timeout, this, &StatusBarServer::drain);
 }
 
 StatusBarServer::~StatusBarServer()
 {
+    // ask them all to stop first, then wait for each
+    for (int i = 0; i < d->threads.size(); ++i) {
+        StatusProvider *provider = d->providers[i];
+        QMetaObject::invokeMethod(provider, [provider]() {
+            provider->stop();
+            QThread::currentThread()->quit();
+        }, Qt::QueuedConnection);
+    }
+
+    // the providers are deleted as their thread finishes
+    for (QThread *thread : qAsConst(d->threads)) {
+        thread->wait();
+        delete thread;
+    }
+
+    for (int i = d->threads.size(); i < d->providers.size(); ++i)
+        delete d->providers[i];
+
     delete d;
 }
 
-QList<int> StatusBarServer::getAvailablePlaceholders() const
+int StatusBarServer::addProvider(StatusProvider *provider)
 {
-    QList<int> ret;
-    for (int i = 0; i < SupportedCount; ++i) {
-        ret.append(i);
+    Q_ASSERT(d->threads.isEmpty());
+
+    if (d->providers.size() == MaxSlots) {
+        qWarning() << "Too many status providers, dropping" << provider->indicator().name;
+        delete provider;
+        return -1;
     }
-    return ret;
+
+    // moved to a thread of its own in start()
+    provider->setParent(nullptr);
+    provider->m_server = this;
+    provider->m_slot = d->providers.size();
+    d->providers.append(provider);
+
+    return provider->m_slot;
 }
 
-QString StatusBarServer::getStatusIcon(int placeholderIndex) const
+void StatusBarServer::loadProviders()
 {
-    QString ret;
-    if (-1 < placeholderIndex && placeholderIndex < SupportedCount)
-        ret = d->icons[placeholderIndex];
-    return ret;
+    const char *names = getenv("HOMESCREEN_STATUS_PROVIDERS");
+    const char *plugin_dir = getenv("HOMESCREEN_STATUS_PLUGIN_DIR");
+    const QStringList list = QString::fromLocal8Bit(names ? names : DEFAULT_PROVIDERS)
+        .split(QLatin1Char(','), Qt::SkipEmptyParts);
+
+    for (const QString &name : list) {
+        StatusProvider *provider = createStatusProvider(name.trimmed());
+        if (provider)
+            addProvider(provider);
+        else
+            qWarning() << "Unknown status provider" << name;
+    }
+
+    if (!plugin_dir)
+        return;
+
+    QDir dir(QString::fromLocal8Bit(plugin_dir));
+    for (const QString &file : dir.entryList(QDir::Files, QDir::Name)) {
+        // plugins stay loaded, the providers use their code until exit
+        QPluginLoader loader(dir.absoluteFilePath(file));
+        StatusProviderPlugin *plugin = qobject_cast<StatusProviderPlugin *>(loader.instance());
+
+        if (!plugin) {
+            qWarning() << "Not a status provider plugin:" << file << loader.errorString();
+            continue;
+        }
+
+        const QList<StatusProvider *> providers = plugin->createProviders();
+        for (StatusProvider *provider : providers)
+            addProvider(provider);
+    }
 }
 
-void StatusBarServer::setStatusIcon(int placeholderIndex, const QString &icon)
+void StatusBarServer::start()
 {
-    if (-1 < placeholderIndex && placeholderIndex < SupportedCount) {
-        if (d->icons[placeholderIndex] == icon) return;
-        d->icons[placeholderIndex] = icon;
-        emit statusIconChanged(placeholderIndex, icon);
+    if (!d->threads.isEmpty())
+        return;
+
+    for (StatusProvider *provider : qAsConst(d->providers)) {
+        QThread *thread = new QThread;
+
+        thread->setObjectName(QStringLiteral("status-%1").arg(provider->indicator().name));
+        provider->moveToThread(thread);
+        connect(thread, &QThread::finished, provider, &QObject::deleteLater);
+        thread->start(QThread::LowPriority);
+
+        QMetaObject::invokeMethod(provider, [provider]() { provider->start(); },
+                                  Qt::QueuedConnection);
+        d->threads.append(thread);
     }
 }
 
-QString StatusBarServer::getStatusText(int placeholderIndex) const
+int StatusBarServer::count() const
 {
-    QString ret;
-    if (-1 < placeholderIndex && placeholderIndex < SupportedCount) {
-        ret = d->texts[placeholderIndex];
-    }
-    return ret;
+    return d->providers.size();
+}
+
+StatusIndicators::Spec StatusBarServer::indicator(int slot) const
+{
+    return d->providers[slot]->indicator();
+}
+
+bool StatusBarServer::available(int slot) const
+{
+    return d->current[slot] >> 32;
+}
+
+int StatusBarServer::level(int slot) const
+{
+    return int(quint32(d->current[slot]));
+}
+
+void StatusBarServer::publish(int slot, bool available, int level)
+{
+    quint64 value = pack(available, level);
+
+    if (slot < 0 || slot >= MaxSlots)
+        return;
+
+    if (d->values[slot].exchange(value) == value)
+        return;
+
+    d->dirty.fetch_or(quint64(1) << slot);
+
+    if (!d->drain_scheduled.exchange(true))
+        QMetaObject::invokeMethod(this, &StatusBarServer::scheduleDrain, Qt::QueuedConnection);
+}
+
+void StatusBarServer::scheduleDrain()
+{
+    qint64 wait = FRAME_MS - d->since_drain.elapsed();
+
+    if (!d->frame.isActive())
+        d->frame.start(wait > 0 ? int(wait) : 0);
 }
 
-void StatusBarServer::setStatusText(int placeholderIndex, const QString &text)
+void StatusBarServer::drain()
 {
-    if (-1 < placeholderIndex && placeholderIndex < SupportedCount) {
-        if (d->texts[placeholderIndex] == text) return;
-        d->texts[placeholderIndex] = text;
-        emit statusTextChanged(placeholderIndex, text);
+    quint64 mask, changed = 0;
+
+    d->drain_scheduled = false;
+    d->since_drain.restart();
+
+    mask = d->dirty.exchange(0);
+    while (mask) {
+        int slot = qCountTrailingZeroBits(mask);
+        quint64 value = d->values[slot].load();
+
+        mask &= mask - 1;
+        if (value == d->current[slot])
+            continue;
+
+        d->current[slot] = value;
+        changed |= quint64(1) << slot;
     }
+
+    if (changed)
+        emit slotsChanged(changed);
 }
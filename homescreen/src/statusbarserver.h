@@ -19,34 +19,56 @@
 
 #include <QtCore/QObject>
 
+#include "statusindicators.h"
+
+class StatusProvider;
+
+/*
+ * Runs the status providers, each on a thread of its own, and collects
+ * their readings for StatusBarModel.
+ *
+ * Providers publish into a table of atomic slots, one per provider, and a
+ * mask of the slots that changed; the first change after a drain schedules
+ * the next one on the GUI thread, paced to a frame, which hands all the
+ * changes over at once with slotsChanged(). Neither side ever waits for the
+ * other, so a slow provider only delays its own readings.
+ *
+ * Which providers run is configuration: the built-in ones named in
+ * HOMESCREEN_STATUS_PROVIDERS, and those of the plugins in
+ * HOMESCREEN_STATUS_PLUGIN_DIR.
+ */
 class StatusBarServer : public QObject
 {
     Q_OBJECT
 public:
-    enum {
-        StatusWifi = 0,
-        StatusBluetooth = 1,
-        StatusCellular = 2,
-        SupportedCount = 3,
-    };
-    explicit StatusBarServer(QObject *parent = NULL);
+    enum { MaxSlots = 64 };
+
+    explicit StatusBarServer(QObject *parent = nullptr);
     ~StatusBarServer();
 
-    Q_INVOKABLE QList<int> getAvailablePlaceholders() const;
-    Q_INVOKABLE QString getStatusIcon(int placeholderIndex) const;
-    Q_INVOKABLE QString getStatusText(int placeholderIndex) const;
+    // GUI thread, before start(); takes ownership, returns the slot or -1
+    int addProvider(StatusProvider *provider);
+    void loadProviders();
+    void start();
+
+    int count() const;
+    StatusIndicators::Spec indicator(int slot) const;
+    // as of the last slotsChanged()
+    bool available(int slot) const;
+    int level(int slot) const;
 
-public slots:
-    void setStatusIcon(int placeholderIndex, const QString &icon);
-    void setStatusText(int placeholderIndex, const QString &text);
+    // any thread
+    void publish(int slot, bool available, int level);
 
 signals:
-    void statusIconChanged(int placeholderIndex, const QString &icon);
-    void statusTextChanged(int placeholderIndex, const QString &text);
+    // one bit per slot whose reading changed
+    void slotsChanged(quint64 slots);
 
 private:
     class Private;
     Private *d;
+    void scheduleDrain();
+    void drain();
 };
 
 #endif // STATUSBARSERVER_H
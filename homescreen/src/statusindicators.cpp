@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QString>
+
+#include "statusindicators.h"
+
+#define MAX_LEVELS	5
+
+struct indicator_level {
+	int min;
+	const char *icon;
+};
+
+struct indicator_spec {
+	const char *off_icon;
+	int hysteresis;
+	int n_levels;
+	struct indicator_level levels[MAX_LEVELS];
+};
+
+/* in StatusIndicators::Indicator order; levels in percent */
+static const struct indicator_spec indicator_specs[StatusIndicators::BuiltinCount] = {
+	/* Bluetooth */ {
+		"image://icons/Status/HMI_Status_Bluetooth_Inactive-01.png", 0, 1, {
+			{ 0, "image://icons/Status/HMI_Status_Bluetooth_On-01.png" },
+		},
+	},
+	/* Wifi */ {
+		"image://icons/Status/HMI_Status_Wifi_NoBars-01.png", 5, 4, {
+			{ 0, "image://icons/Status/HMI_Status_Wifi_1Bar-01.png" },
+			{ 30, "image://icons/Status/HMI_Status_Wifi_2Bars-01.png" },
+			{ 50, "image://icons/Status/HMI_Status_Wifi_3Bars-01.png" },
+			{ 70, "image://icons/Status/HMI_Status_Wifi_Full-01.png" },
+		},
+	},
+};
+
+/*
+ * Not built in, it comes from a status provider, but the status bar shows
+ * its off icon even without one.
+ */
+static const struct indicator_spec cellular_spec = {
+	"image://icons/Status/HMI_Status_Signal_NoBars-01.png", 5, 5, {
+		{ 0, "image://icons/Status/HMI_Status_Signal_1Bars-01.png" },
+		{ 20, "image://icons/Status/HMI_Status_Signal_2Bars-01.png" },
+		{ 40, "image://icons/Status/HMI_Status_Signal_3Bars-01.png" },
+		{ 60, "image://icons/Status/HMI_Status_Signal_4Bars-01.png" },
+		{ 80, "image://icons/Status/HMI_Status_Signal_Full-01.png" },
+	},
+};
+
+static StatusIndicators::Spec
+spec_from_table(const struct indicator_spec &table)
+{
+	StatusIndicators::Spec spec;
+
+	spec.off_icon = QUrl(QString::fromLatin1(table.off_icon));
+	spec.hysteresis = table.hysteresis;
+	for (int l = 0; l < table.n_levels; l++)
+		spec.levels.append({ table.levels[l].min,
+				     QUrl(QString::fromLatin1(table.levels[l].icon)) });
+	return spec;
+}
+
+StatusIndicators::StatusIndicators()
+{
+	for (const struct indicator_spec &table : indicator_specs)
+		add(spec_from_table(table));
+}
+
+StatusIndicators::Spec StatusIndicators::cellular()
+{
+	Spec spec = spec_from_table(cellular_spec);
+
+	spec.name = QStringLiteral("cellular");
+	return spec;
+}
+
+int StatusIndicators::add(const Spec &spec)
+{
+	State state;
+
+	state.off_icon = spec.off_icon;
+	state.hysteresis = spec.hysteresis;
+	state.text = spec.text;
+	for (const Level &level : spec.levels) {
+		state.thresholds.append(level.min);
+		state.icons.append(level.icon);
+	}
+
+	m_state.append(state);
+	return m_state.size() - 1;
+}
+
+bool StatusIndicators::set(int indicator, bool available, int level)
+{
+	State &state = m_state[indicator];
+	bool text_changed = false;
+	int bucket = state.bucket;
+	int n = state.thresholds.size();
+
+	if (!available) {
+		bucket = -1;
+	} else if (bucket < 0) {
+		// fresh reading, no hysteresis
+		bucket = 0;
+		while (bucket + 1 < n && level >= state.thresholds[bucket + 1])
+			bucket++;
+	} else {
+		while (bucket + 1 < n && level >= state.thresholds[bucket + 1])
+			bucket++;
+		while (bucket > 0 && level < state.thresholds[bucket] - state.hysteresis)
+			bucket--;
+	}
+
+	if (!state.text.isEmpty() && bucket >= 0 && level != state.level) {
+		state.level = level;
+		text_changed = true;
+	}
+
+	if (bucket == state.bucket)
+		return text_changed;
+
+	state.bucket = bucket;
+	return true;
+}
+
+const QUrl &StatusIndicators::icon(int indicator) const
+{
+	const State &state = m_state[indicator];
+
+	// text only indicators have no icons, and an empty off icon
+	if (state.bucket < 0 || state.icons.isEmpty())
+		return state.off_icon;
+
+	return state.icons[state.bucket];
+}
+
+QString StatusIndicators::text(int indicator) const
+{
+	const State &state = m_state[indicator];
+
+	if (state.bucket < 0 || state.text.isEmpty())
+		return QString();
+
+	if (!state.text.contains(QLatin1String("%1")))
+		return state.text;
+
+	return state.text.arg(state.level);
+}
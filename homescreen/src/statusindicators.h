@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STATUSINDICATORS_H
+#define STATUSINDICATORS_H
+
+#include <QString>
+#include <QUrl>
+#include <QVector>
+
+/*
+ * The icons of the status bar indicators, driven by a table per indicator
+ * (see statusindicators.cpp for the built-in ones, the status providers
+ * bring their own): the level thresholds, in ascending order, with the icon
+ * shown from each one up, and the icon shown while the indicator is
+ * unavailable. Indicators without artwork show their level as text
+ * instead.
+ *
+ * A level has to drop a hysteresis band below the threshold it crossed to
+ * go back down, so that a signal wobbling around a threshold doesn't make
+ * the icon flicker. Icon URLs are built once, and set() only reports a
+ * change when the indicator moves to another icon, or text.
+ */
+class StatusIndicators
+{
+public:
+	// built in, also the order they are shown in, before any added ones
+	enum Indicator {
+		Bluetooth,
+		Wifi,
+		BuiltinCount,
+	};
+
+	struct Level {
+		int min;
+		QUrl icon;
+	};
+
+	struct Spec {
+		QString name;
+		QUrl off_icon;
+		/* in ascending order; may be empty with a text */
+		QVector<Level> levels;
+		int hysteresis = 0;
+		/* shown while available, %1 being the level, e.g. "%1%" */
+		QString text;
+	};
+
+	StatusIndicators();
+
+	/* the cellular signal, for its provider and the icon shown without one */
+	static Spec cellular();
+
+	/* returns the index of the new indicator */
+	int add(const Spec &spec);
+	int count() const { return m_state.size(); }
+
+	/* returns true if the icon or the text of the indicator changed */
+	bool set(int indicator, bool available, int level = 0);
+
+	const QUrl &icon(int indicator) const;
+	QString text(int indicator) const;
+	/* -1 while unavailable */
+	int bucket(int indicator) const { return m_state[indicator].bucket; }
+
+private:
+	struct State {
+		QUrl off_icon;
+		QVector<int> thresholds;
+		QVector<QUrl> icons;
+		QString text;
+		int hysteresis = 0;
+		int bucket = -1;
+		int level = 0;
+	};
+
+	QVector<State> m_state;
+};
+
+#endif // STATUSINDICATORS_H
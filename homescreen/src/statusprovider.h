@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STATUSPROVIDER_H
+#define STATUSPROVIDER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QtPlugin>
+
+#include "statusindicators.h"
+
+class StatusBarServer;
+
+/*
+ * A source of one status bar indicator, e.g. the cellular signal or the
+ * battery level, see StatusBarServer.
+ *
+ * Each provider lives on a thread of its own, where start() is called; it
+ * then polls from a timer or subscribes to its service there, and calls
+ * publish() with every reading. Blocking calls only hold up the provider's
+ * own thread, but should still time out: the homescreen waits for stop()
+ * when it exits.
+ */
+class StatusProvider : public QObject
+{
+public:
+	StatusProvider() = default;
+
+	/* GUI thread, before start(): the icons, or text, of the readings */
+	virtual StatusIndicators::Spec indicator() const = 0;
+
+	/* the provider's thread */
+	virtual void start() = 0;
+	virtual void stop() {}
+
+protected:
+	/* any thread; cheap, readings that didn't change are dropped */
+	void publish(bool available, int level = 0);
+
+private:
+	friend class StatusBarServer;
+
+	StatusBarServer *m_server = nullptr;
+	int m_slot = -1;
+};
+
+/*
+ * Implemented by the Qt plugins found in HOMESCREEN_STATUS_PLUGIN_DIR; the
+ * providers are owned by the homescreen once created.
+ */
+class StatusProviderPlugin
+{
+public:
+	virtual ~StatusProviderPlugin() = default;
+
+	virtual QList<StatusProvider *> createProviders() = 0;
+};
+
+#define StatusProviderPlugin_iid "org.automotivelinux.homescreen.StatusProviderPlugin/1.0"
+Q_DECLARE_INTERFACE(StatusProviderPlugin, StatusProviderPlugin_iid)
+
+/* the built-in providers: cellular, battery, gnss and thermal */
+StatusProvider *createStatusProvider(const QString &name);
+
+#endif // STATUSPROVIDER_H
@@ -0,0 +1,406 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#ifdef HAVE_QT_DBUS
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QDBusVariant>
+#endif
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "statusbarserver.h"
+#include "statusprovider.h"
+
+#define BATTERY_POLL_MS		30000
+#define THERMAL_POLL_MS		5000
+#define CELLULAR_POLL_MS	5000
+#define GPSD_RETRY_MS		5000
+#define GPSD_PORT		2947
+// for the D-Bus calls, which block the provider's thread
+#define CALL_TIMEOUT_MS		1000
+
+void StatusProvider::publish(bool available, int level)
+{
+	if (m_server)
+		m_server->publish(m_slot, available, level);
+}
+
+static bool
+read_sysfs_int(const QString &path, int *value)
+{
+	QFile file(path);
+	bool ok = false;
+
+	if (file.open(QIODevice::ReadOnly))
+		*value = file.readAll().trimmed().toInt(&ok);
+
+	return ok;
+}
+
+/* reads a number out of sysfs every few seconds */
+class SysfsProvider : public StatusProvider
+{
+public:
+	SysfsProvider(int interval) : m_interval(interval) {}
+
+	void start() override
+	{
+		m_path = findPath();
+		if (m_path.isEmpty()) {
+			publish(false);
+			return;
+		}
+
+		m_timer = new QTimer(this);
+		connect(m_timer, &QTimer::timeout, this, [this]() { poll(); });
+		m_timer->start(m_interval);
+		poll();
+	}
+
+	void stop() override
+	{
+		if (m_timer)
+			m_timer->stop();
+	}
+
+protected:
+	virtual QString findPath() const = 0;
+	virtual int level(int value) const { return value; }
+
+private:
+	void poll()
+	{
+		int value;
+
+		if (read_sysfs_int(m_path, &value))
+			publish(true, level(value));
+		else
+			publish(false);
+	}
+
+	int m_interval;
+	QString m_path;
+	QTimer *m_timer = nullptr;
+};
+
+class BatteryProvider : public SysfsProvider
+{
+public:
+	BatteryProvider() : SysfsProvider(BATTERY_POLL_MS) {}
+
+	StatusIndicators::Spec indicator() const override
+	{
+		StatusIndicators::Spec spec;
+
+		spec.name = QStringLiteral("battery");
+		spec.text = QStringLiteral("%1%");
+		return spec;
+	}
+
+protected:
+	QString findPath() const override
+	{
+		QDir dir(QStringLiteral("/sys/class/power_supply"));
+
+		for (const QString &supply : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+			QFile type(dir.filePath(supply + QStringLiteral("/type")));
+
+			if (type.open(QIODevice::ReadOnly) && type.readAll().trimmed() == "Battery")
+				return dir.filePath(supply + QStringLiteral("/capacity"));
+		}
+
+		return QString();
+	}
+};
+
+class ThermalProvider : public SysfsProvider
+{
+public:
+	ThermalProvider() : SysfsProvider(THERMAL_POLL_MS) {}
+
+	StatusIndicators::Spec indicator() const override
+	{
+		StatusIndicators::Spec spec;
+
+		spec.name = QStringLiteral("thermal");
+		spec.text = QStringLiteral("%1°C");
+		return spec;
+	}
+
+protected:
+	QString findPath() const override
+	{
+		QString path = QStringLiteral("/sys/class/thermal/thermal_zone0/temp");
+
+		return QFile::exists(path) ? path : QString();
+	}
+
+	/* millidegrees */
+	int level(int value) const override { return value / 1000; }
+};
+
+/*
+ * The satellites used for the fix, from gpsd; the indicator is available
+ * with a 2D fix or better.
+ */
+class GnssProvider : public StatusProvider
+{
+public:
+	StatusIndicators::Spec indicator() const override
+	{
+		StatusIndicators::Spec spec;
+
+		spec.name = QStringLiteral("gnss");
+		spec.text = QStringLiteral("%1 sat");
+		return spec;
+	}
+
+	void start() override
+	{
+		m_retry = new QTimer(this);
+		m_retry->setSingleShot(true);
+		connect(m_retry, &QTimer::timeout, this, [this]() { connectGpsd(); });
+		connectGpsd();
+	}
+
+	void stop() override
+	{
+		if (m_retry)
+			m_retry->stop();
+		disconnectGpsd();
+	}
+
+private:
+	void connectGpsd()
+	{
+		static const char watch[] = "?WATCH={\"enable\":true,\"json\":true};\n";
+		struct sockaddr_in addr = {};
+
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(GPSD_PORT);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		m_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (m_fd < 0 ||
+		    ::connect(m_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 ||
+		    write(m_fd, watch, sizeof(watch) - 1) < 0) {
+			disconnectGpsd();
+			m_retry->start(GPSD_RETRY_MS);
+			return;
+		}
+
+		m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+		connect(m_notifier, &QSocketNotifier::activated, this, [this]() { readGpsd(); });
+	}
+
+	void disconnectGpsd()
+	{
+		delete m_notifier;
+		m_notifier = nullptr;
+		if (m_fd >= 0)
+			close(m_fd);
+		m_fd = -1;
+		m_buffer.clear();
+		m_mode = 0;
+	}
+
+	void readGpsd()
+	{
+		char buf[4096];
+		ssize_t len = read(m_fd, buf, sizeof(buf));
+		int end;
+
+		if (len <= 0) {
+			disconnectGpsd();
+			publish(false);
+			m_retry->start(GPSD_RETRY_MS);
+			return;
+		}
+
+		m_buffer.append(buf, len);
+		while ((end = m_buffer.indexOf('\n')) >= 0) {
+			handleReport(QJsonDocument::fromJson(m_buffer.left(end)).object());
+			m_buffer.remove(0, end + 1);
+		}
+
+		publish(m_mode >= 2, m_used);
+	}
+
+	void handleReport(const QJsonObject &report)
+	{
+		QString type = report.value(QStringLiteral("class")).toString();
+
+		if (type == QLatin1String("TPV")) {
+			m_mode = report.value(QStringLiteral("mode")).toInt();
+		} else if (type == QLatin1String("SKY")) {
+			const QJsonArray satellites = report.value(QStringLiteral("satellites")).toArray();
+
+			// SKY reports without satellites only carry the DOPs
+			if (satellites.isEmpty())
+				return;
+
+			m_used = 0;
+			for (const QJsonValue &satellite : satellites)
+				if (satellite.toObject().value(QStringLiteral("used")).toBool())
+					m_used++;
+		}
+	}
+
+	int m_fd = -1;
+	QSocketNotifier *m_notifier = nullptr;
+	QTimer *m_retry = nullptr;
+	QByteArray m_buffer;
+	int m_mode = 0;
+	int m_used = 0;
+};
+
+#ifdef HAVE_QT_DBUS
+typedef QMap<QString, QVariantMap> DBusInterfaces;
+typedef QMap<QDBusObjectPath, DBusInterfaces> DBusManagedObjects;
+Q_DECLARE_METATYPE(DBusInterfaces)
+Q_DECLARE_METATYPE(DBusManagedObjects)
+
+#define MM_SERVICE		"org.freedesktop.ModemManager1"
+#define MM_PATH			"/org/freedesktop/ModemManager1"
+#define MM_MODEM_INTERFACE	"org.freedesktop.ModemManager1.Modem"
+// and above: searching is below, connecting and connected above
+#define MM_MODEM_STATE_REGISTERED	8
+
+/*
+ * The signal quality of the first modem ModemManager knows of, polled:
+ * the calls are cheap and a modem can come and go at any time.
+ */
+class CellularProvider : public StatusProvider
+{
+public:
+	StatusIndicators::Spec indicator() const override
+	{
+		return StatusIndicators::cellular();
+	}
+
+	void start() override
+	{
+		qDBusRegisterMetaType<DBusInterfaces>();
+		qDBusRegisterMetaType<DBusManagedObjects>();
+
+		m_timer = new QTimer(this);
+		connect(m_timer, &QTimer::timeout, this, [this]() { poll(); });
+		m_timer->start(CELLULAR_POLL_MS);
+		poll();
+	}
+
+	void stop() override
+	{
+		if (m_timer)
+			m_timer->stop();
+	}
+
+private:
+	QDBusMessage call(const QDBusMessage &message) const
+	{
+		return QDBusConnection::systemBus().call(message, QDBus::Block, CALL_TIMEOUT_MS);
+	}
+
+	QVariant property(const char *name) const
+	{
+		QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral(MM_SERVICE), m_modem,
+								      QStringLiteral("org.freedesktop.DBus.Properties"),
+								      QStringLiteral("Get"));
+		message << QStringLiteral(MM_MODEM_INTERFACE) << QLatin1String(name);
+
+		QDBusMessage reply = call(message);
+		if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty())
+			return QVariant();
+
+		return reply.arguments().first().value<QDBusVariant>().variant();
+	}
+
+	void findModem()
+	{
+		QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral(MM_SERVICE),
+								      QStringLiteral(MM_PATH),
+								      QStringLiteral("org.freedesktop.DBus.ObjectManager"),
+								      QStringLiteral("GetManagedObjects"));
+		QDBusMessage reply = call(message);
+		DBusManagedObjects objects;
+
+		if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty())
+			return;
+
+		reply.arguments().first().value<QDBusArgument>() >> objects;
+		for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+			if (it.value().contains(QStringLiteral(MM_MODEM_INTERFACE))) {
+				m_modem = it.key().path();
+				return;
+			}
+		}
+	}
+
+	void poll()
+	{
+		QVariant state, quality;
+		uint percent = 0;
+		bool recent = false;
+
+		if (m_modem.isEmpty())
+			findModem();
+		if (m_modem.isEmpty()) {
+			publish(false);
+			return;
+		}
+
+		state = property("State");
+		if (!state.isValid()) {
+			// gone, look for another one next time
+			m_modem.clear();
+			publish(false);
+			return;
+		}
+
+		quality = property("SignalQuality");
+		if (quality.isValid()) {
+			const QDBusArgument arg = quality.value<QDBusArgument>();
+
+			arg.beginStructure();
+			arg >> percent >> recent;
+			arg.endStructure();
+		}
+
+		publish(state.toInt() >= MM_MODEM_STATE_REGISTERED, int(percent));
+	}
+
+	QString m_modem;
+	QTimer *m_timer = nullptr;
+};
+#endif
+
+StatusProvider *createStatusProvider(const QString &name)
+{
+#ifdef HAVE_QT_DBUS
+	if (name == QLatin1String("cellular"))
+		return new CellularProvider;
+#endif
+	if (name == QLatin1String("battery"))
+		return new BatteryProvider;
+	if (name == QLatin1String("gnss"))
+		return new GnssProvider;
+	if (name == QLatin1String("thermal"))
+		return new ThermalProvider;
+
+	return nullptr;
+}
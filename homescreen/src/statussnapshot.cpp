@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <signal.h>
+
+#include "hmi-debug.h"
+#include "signalnotifier.h"
+#include "statussnapshot.h"
+
+#define SNAPSHOT_MAGIC		0x4853534e	/* "HSSN" */
+#define SNAPSHOT_VERSION	1
+/* the Wi-Fi strength changes all the time; spare the flash */
+#define SAVE_DELAY_MS		30000
+
+StatusSnapshot *StatusSnapshot::instance()
+{
+	static StatusSnapshot *snapshot = new StatusSnapshot(QCoreApplication::instance());
+	return snapshot;
+}
+
+StatusSnapshot::StatusSnapshot(QObject *parent) :
+	QObject(parent)
+{
+	m_path = QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) +
+		 QStringLiteral("/homescreen/status.snapshot");
+
+	load();
+
+	m_save.setSingleShot(true);
+	m_save.setInterval(SAVE_DELAY_MS);
+	connect(&m_save, &QTimer::timeout, this, &StatusSnapshot::save);
+}
+
+StatusSnapshot::~StatusSnapshot()
+{
+	if (m_save.isActive())
+		save();
+}
+
+/*
+ * The homescreen is stopped with SIGTERM, which never gets to the
+ * destructor: write what's pending first, then die of it as before. Only
+ * once the event loop runs, the signal is held up until then.
+ */
+void StatusSnapshot::catchTerm()
+{
+	SignalNotifier *sigterm = new SignalNotifier(SIGTERM, this);
+
+	connect(sigterm, &SignalNotifier::activated, this, [this]() {
+		if (m_save.isActive())
+			save();
+
+		signal(SIGTERM, SIG_DFL);
+		raise(SIGTERM);
+	});
+}
+
+void StatusSnapshot::load()
+{
+	QFile file(m_path);
+	quint32 magic = 0;
+	quint16 version = 0;
+	Values values;
+
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+
+	in >> magic >> version;
+	if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		HMI_WARNING("HomeScreen", "Ignoring %s, not a version %d snapshot",
+			    qPrintable(m_path), SNAPSHOT_VERSION);
+		return;
+	}
+
+	in >> values.condition >> values.temperature
+	   >> values.wifi_available >> values.wifi_strength
+	   >> values.bluetooth_power >> values.volume;
+	if (in.status() != QDataStream::Ok) {
+		HMI_WARNING("HomeScreen", "Ignoring truncated %s", qPrintable(m_path));
+		return;
+	}
+
+	m_restored = values;
+	m_current = values;
+	m_valid = true;
+}
+
+void StatusSnapshot::save()
+{
+	QSaveFile file(m_path);
+
+	m_save.stop();
+
+	QDir().mkpath(QFileInfo(m_path).path());
+	if (!file.open(QIODevice::WriteOnly)) {
+		HMI_WARNING("HomeScreen", "Unable to write %s: %s", qPrintable(m_path),
+			    qPrintable(file.errorString()));
+		return;
+	}
+
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+
+	out << quint32(SNAPSHOT_MAGIC) << quint16(SNAPSHOT_VERSION);
+	out << m_current.condition << m_current.temperature
+	    << m_current.wifi_available << m_current.wifi_strength
+	    << m_current.bluetooth_power << m_current.volume;
+
+	// renamed over the previous snapshot only once complete
+	if (!file.commit())
+		HMI_WARNING("HomeScreen", "Unable to write %s: %s", qPrintable(m_path),
+			    qPrintable(file.errorString()));
+}
+
+void StatusSnapshot::changed()
+{
+	if (!m_save.isActive())
+		m_save.start();
+}
+
+void StatusSnapshot::setCondition(const QString &condition)
+{
+	if (m_current.condition == condition)
+		return;
+
+	m_current.condition = condition;
+	changed();
+}
+
+void StatusSnapshot::setTemperature(const QString &temperature)
+{
+	if (m_current.temperature == temperature)
+		return;
+
+	m_current.temperature = temperature;
+	changed();
+}
+
+void StatusSnapshot::setWifi(bool available, int strength)
+{
+	if (m_current.wifi_available == available && m_current.wifi_strength == strength)
+		return;
+
+	m_current.wifi_available = available;
+	m_current.wifi_strength = strength;
+	changed();
+}
+
+void StatusSnapshot::setBluetoothPower(bool power)
+{
+	if (m_current.bluetooth_power == power)
+		return;
+
+	m_current.bluetooth_power = power;
+	changed();
+}
+
+void StatusSnapshot::setVolume(int volume)
+{
+	if (m_current.volume == volume)
+		return;
+
+	m_current.volume = volume;
+	changed();
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STATUSSNAPSHOT_H
+#define STATUSSNAPSHOT_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/*
+ * The last known weather, Wi-Fi, Bluetooth and volume state, kept across
+ * boots so that the status area starts out showing them rather than
+ * placeholders while the services connect, which takes seconds.
+ *
+ * The snapshot is read synchronously on first use, before the QML is
+ * created, and exposed to it as the "snapshot" context property; the live
+ * values replace it as they come in. Those are recorded as they change and
+ * written out a while later, and on SIGTERM, with a version header,
+ * through QSaveFile so that a power cut never leaves a torn file behind.
+ */
+class StatusSnapshot : public QObject
+{
+	Q_OBJECT
+	Q_PROPERTY(bool valid READ valid CONSTANT)
+	Q_PROPERTY(QString condition READ condition CONSTANT)
+	Q_PROPERTY(QString temperature READ temperature CONSTANT)
+
+public:
+	struct Values {
+		QString condition;
+		QString temperature;
+		bool wifi_available = false;
+		int wifi_strength = 0;
+		bool bluetooth_power = false;
+		/* -1 until known */
+		int volume = -1;
+	};
+
+	static StatusSnapshot *instance();
+
+	~StatusSnapshot();
+
+	/* what was restored, valid() if anything was */
+	bool valid() const { return m_valid; }
+	const Values &restored() const { return m_restored; }
+	QString condition() const { return m_restored.condition; }
+	QString temperature() const { return m_restored.temperature; }
+
+	void setCondition(const QString &condition);
+	void setTemperature(const QString &temperature);
+	void setWifi(bool available, int strength);
+	void setBluetoothPower(bool power);
+	void setVolume(int volume);
+
+	/* saves on SIGTERM; right before the event loop, which delivers it */
+	void catchTerm();
+
+private:
+	explicit StatusSnapshot(QObject *parent = nullptr);
+
+	void load();
+	void save();
+	void changed();
+
+	QString m_path;
+	bool m_valid = false;
+	Values m_restored;
+	Values m_current;
+	QTimer m_save;
+};
+
+#endif // STATUSSNAPSHOT_H
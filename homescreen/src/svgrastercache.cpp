@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDirIterator>
+#include <QtMath>
+
+#include "svgrastercache.h"
+
+#define RASTER_ROOT	":/raster/"
+
+SvgRasterCache::SvgRasterCache(qreal devicePixelRatio)
+{
+	// Qt picks the @<n>x variant of an image by itself, based on the
+	// rounded up device pixel ratio of the window
+	int dpr = qCeil(devicePixelRatio);
+	QString suffix = dpr > 1 ? QStringLiteral("@%1x.png").arg(dpr) :
+				   QStringLiteral(".png");
+
+	QDirIterator it(QStringLiteral(RASTER_ROOT), QDir::Files,
+			QDirIterator::Subdirectories);
+	while (it.hasNext()) {
+		QString path = it.next().mid(sizeof(RASTER_ROOT) - 1);
+
+		if (path.endsWith(suffix) && (dpr > 1 || !path.contains(QLatin1Char('@'))))
+			m_rasters.insert(path.left(path.size() - suffix.size()));
+	}
+}
+
+bool SvgRasterCache::isEmpty() const
+{
+	return m_rasters.isEmpty();
+}
+
+QUrl SvgRasterCache::intercept(const QUrl &url, QQmlAbstractUrlInterceptor::DataType type)
+{
+	if (type != QQmlAbstractUrlInterceptor::UrlString ||
+	    url.scheme() != QLatin1String("qrc"))
+		return url;
+
+	QString path = url.path();
+	if (!path.endsWith(QLatin1String(".svg")))
+		return url;
+
+	// "/images/Shortcut/hvac.svg" -> "images/Shortcut/hvac"
+	path = path.mid(1, path.size() - 5);
+	if (!m_rasters.contains(path))
+		return url;
+
+	QUrl raster(url);
+	raster.setPath(QStringLiteral("/raster/") + path + QStringLiteral(".png"));
+	return raster;
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SVGRASTERCACHE_H
+#define SVGRASTERCACHE_H
+
+#include <QSet>
+#include <QString>
+#include <QtQml/QQmlAbstractUrlInterceptor>
+
+/*
+ * Redirects image URLs of SVGs rasterized at build time (tools/svgraster)
+ * to their raster, so that they don't have to be parsed and tessellated at
+ * runtime.
+ *
+ * The rasters are made at the SVG's own size, which is what an Image item
+ * without a sourceSize renders it at. A raster is only used when there is
+ * one for the device pixel ratio of the screen; anything else keeps
+ * loading the SVG.
+ */
+class SvgRasterCache : public QQmlAbstractUrlInterceptor
+{
+public:
+	explicit SvgRasterCache(qreal devicePixelRatio);
+
+	bool isEmpty() const;
+
+	QUrl intercept(const QUrl &url, QQmlAbstractUrlInterceptor::DataType type) override;
+
+private:
+	// paths, relative to :/raster and without extension, of the SVGs
+	// that have a raster for our device pixel ratio
+	QSet<QString> m_rasters;
+};
+
+#endif // SVGRASTERCACHE_H
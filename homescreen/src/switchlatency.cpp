@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDebug>
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "signalnotifier.h"
+#include "switchlatency.h"
+
+#define SUB_BUCKET_BITS		4
+#define SUB_BUCKETS		(1 << SUB_BUCKET_BITS)
+/* values up to 2^40 us, a dozen days, are kept exactly enough */
+#define MAX_MAGNITUDE		40
+
+/* a switch still in flight after this long is forgotten */
+#define STALE_SWITCH_US		(60ULL * 1000 * 1000)
+
+static const char *stage_names[SwitchLatency::StageCount] = {
+	"total", "launch requested", "started", "activate sent", "activated"
+};
+
+static uint64_t
+now_usec()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static size_t
+bucket_index(uint64_t value)
+{
+	int magnitude;
+
+	if (value < SUB_BUCKETS)
+		return value;
+
+	magnitude = 63 - __builtin_clzll(value);
+	if (magnitude > MAX_MAGNITUDE)
+		return (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) * SUB_BUCKETS - 1;
+
+	return (magnitude - SUB_BUCKET_BITS + 1) * SUB_BUCKETS +
+		((value >> (magnitude - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+}
+
+static uint64_t
+bucket_upper_bound(size_t index)
+{
+	size_t magnitude = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+	uint64_t sub = index % SUB_BUCKETS;
+
+	if (index < SUB_BUCKETS)
+		return index;
+
+	return ((SUB_BUCKETS + sub + 1) << (magnitude - SUB_BUCKET_BITS)) - 1;
+}
+
+LatencyHistogram::LatencyHistogram() :
+	m_buckets((MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) * SUB_BUCKETS, 0)
+{
+}
+
+void LatencyHistogram::record(uint64_t value)
+{
+	m_buckets[bucket_index(value)]++;
+	m_count++;
+	if (value > m_max)
+		m_max = value;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const
+{
+	uint64_t rank = (uint64_t) (p / 100.0 * m_count + 0.5);
+	uint64_t seen = 0;
+
+	if (m_count == 0)
+		return 0;
+	if (rank < 1)
+		rank = 1;
+
+	for (size_t i = 0; i < m_buckets.size(); i++) {
+		seen += m_buckets[i];
+		if (seen >= rank) {
+			uint64_t bound = bucket_upper_bound(i);
+			return bound < m_max ? bound : m_max;
+		}
+	}
+
+	return m_max;
+}
+
+SwitchLatency::SwitchLatency(QObject *parent) :
+	QObject(parent)
+{
+	SignalNotifier *sigusr1 = new SignalNotifier(SIGUSR1, this);
+
+	connect(sigusr1, &SignalNotifier::activated, this, [this]() { dump(); });
+}
+
+void SwitchLatency::mark(const QString &app_id, Stage stage, bool cold)
+{
+	uint64_t now = now_usec();
+	auto it = m_pending.find(app_id);
+
+	if (it != m_pending.end()) {
+		uint64_t first = 0;
+		for (uint64_t at : it->at)
+			if (at && (!first || at < first))
+				first = at;
+
+		// a new tap starts a new switch, as does one long forgotten
+		if (stage == Tap || now - first > STALE_SWITCH_US) {
+			m_pending.erase(it);
+			it = m_pending.end();
+		}
+	}
+
+	if (it == m_pending.end()) {
+		// re-activations after a terminate, app_on_output moves and the
+		// like only extend a switch, they aren't one
+		if (stage != Tap && stage != Started)
+			return;
+
+		Switch sw = {};
+		sw.cold = cold;
+		it = m_pending.insert(app_id, sw);
+	}
+
+	// applaunchd and the compositor both report the start; the first wins
+	if (!it->at[stage])
+		it->at[stage] = now;
+}
+
+void SwitchLatency::finish(const QString &app_id)
+{
+	auto it = m_pending.find(app_id);
+
+	if (it == m_pending.end())
+		return;
+
+	Switch sw = it.value();
+	m_pending.erase(it);
+	sw.at[Activated] = now_usec();
+
+	AppHistograms &hist = m_histograms[app_id];
+	uint64_t first = 0, previous = 0;
+
+	for (int stage = Tap; stage < StageCount; stage++) {
+		uint64_t at = sw.at[stage];
+
+		if (!at)
+			continue;
+		if (!first)
+			first = at;
+		if (previous && stage != Tap)
+			hist.stages[sw.cold][stage].record(at - previous);
+		previous = at;
+	}
+
+	hist.stages[sw.cold][Tap].record(sw.at[Activated] - first);
+}
+
+void SwitchLatency::dump(FILE *f) const
+{
+	fprintf(f, "%-32s %-5s %-17s %7s %9s %9s %9s %9s\n",
+		"app_id", "kind", "stage", "count",
+		"p50 ms", "p95 ms", "p99 ms", "max ms");
+
+	for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+		for (int cold = 1; cold >= 0; cold--) {
+			for (int stage = Tap; stage < StageCount; stage++) {
+				const LatencyHistogram &h = it->stages[cold][stage];
+
+				if (!h.count())
+					continue;
+
+				fprintf(f, "%-32s %-5s %-17s %7llu %9.1f %9.1f %9.1f %9.1f\n",
+					qPrintable(it.key()), cold ? "cold" : "warm",
+					stage_names[stage], (unsigned long long) h.count(),
+					h.percentile(50) / 1000.0, h.percentile(95) / 1000.0,
+					h.percentile(99) / 1000.0, h.max() / 1000.0);
+			}
+		}
+	}
+}
+
+void SwitchLatency::dump() const
+{
+	const char *path = getenv("HOMESCREEN_LATENCY_FILE");
+	FILE *f;
+
+	if (!path || !*path) {
+		dump(stderr);
+		return;
+	}
+
+	f = fopen(path, "w");
+	if (!f) {
+		qWarning() << "Unable to write latency histograms to" << path
+			   << ":" << strerror(errno);
+		return;
+	}
+
+	dump(f);
+	fclose(f);
+}
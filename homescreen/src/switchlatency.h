@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SWITCHLATENCY_H
+#define SWITCHLATENCY_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/*
+ * Log-linear histogram in the style of HdrHistogram: 16 sub-buckets per
+ * power of two, so every recorded value is kept with a relative error
+ * below 1/16, in a fixed amount of memory. Values are microseconds.
+ */
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void record(uint64_t value);
+	/* upper bound of the bucket holding the given percentile (0-100) */
+	uint64_t percentile(double p) const;
+
+	uint64_t count() const { return m_count; }
+	uint64_t max() const { return m_max; }
+
+private:
+	std::vector<uint32_t> m_buckets;
+	uint64_t m_count = 0;
+	uint64_t m_max = 0;
+};
+
+/*
+ * Time from tapping a shortcut to the compositor reporting the application
+ * activated, per app_id, split into the stages the switch goes through:
+ *
+ *   tap -> launch requested (AppLauncherClient::startApplication)
+ *       -> started (applaunchd or agl_shell reports the start)
+ *       -> activate sent (agl_shell_activate_app)
+ *       -> activated (AGL_SHELL_APP_STATE_ACTIVATED)
+ *
+ * Switches to an application that wasn't running are kept apart from those
+ * to one that was. Only a tap or a start opens a switch; a switch that
+ * starts with the latter (an application started by something else) is
+ * measured from there. Later stages without an open switch, e.g. the
+ * activation of the previous application after a terminate, are ignored.
+ *
+ * The histograms are written on SIGUSR1, to HOMESCREEN_LATENCY_FILE if it is
+ * set and to stderr otherwise.
+ */
+class SwitchLatency : public QObject
+{
+	Q_OBJECT
+public:
+	enum Stage {
+		Tap,
+		LaunchRequested,
+		Started,
+		ActivateSent,
+		Activated,
+		StageCount
+	};
+
+	explicit SwitchLatency(QObject *parent = nullptr);
+
+	/* cold: the application wasn't running when the switch began */
+	void mark(const QString &app_id, Stage stage, bool cold);
+	void finish(const QString &app_id);
+
+	void dump(FILE *f) const;
+	void dump() const;
+
+private:
+	struct Switch {
+		bool cold;
+		uint64_t at[StageCount];
+	};
+
+	struct AppHistograms {
+		// [cold][stage]: time from the previous stage seen to stage,
+		// Tap holds the end-to-end time
+		LatencyHistogram stages[2][StageCount];
+	};
+
+	QHash<QString, Switch> m_pending;
+	QHash<QString, AppHistograms> m_histograms;
+};
+
+#endif // SWITCHLATENCY_H
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QCoreApplication>
+
+#include "vehiclesignals.h"
+#include "vehiclesignalhub.h"
+#include "hmi-debug.h"
+
+VehicleSignalChannel::VehicleSignalChannel(const QString &path, VehicleSignalHub *hub) :
+	QObject(hub),
+	m_hub(hub),
+	m_path(path)
+{
+}
+
+void VehicleSignalChannel::set(const QString &value)
+{
+	m_hub->set(m_path, value);
+}
+
+VehicleSignalHub *VehicleSignalHub::instance()
+{
+	static VehicleSignalHub *hub = new VehicleSignalHub(QCoreApplication::instance());
+	return hub;
+}
+
+VehicleSignalHub::VehicleSignalHub(QObject *parent) :
+	QObject(parent)
+{
+	VehicleSignalsConfig vsConfig("homescreen");
+	m_vs = new VehicleSignals(vsConfig);
+	m_vs->setParent(this);
+
+	connect(m_vs, &VehicleSignals::connected, this, [this]() {
+		m_vs->authorize();
+	});
+
+	connect(m_vs, &VehicleSignals::authorized, this, [this]() {
+		m_authorized = true;
+		for (VehicleSignalChannel *channel : qAsConst(m_channels))
+			if (channel->m_refs > 0)
+				subscribe(channel);
+		emit authorizedChanged(true);
+	});
+
+	connect(m_vs, &VehicleSignals::disconnected, this, [this]() {
+		m_authorized = false;
+		// the new connection starts without subscriptions
+		for (VehicleSignalChannel *channel : qAsConst(m_channels))
+			channel->m_subscribed = false;
+		emit authorizedChanged(false);
+	});
+
+	connect(m_vs, &VehicleSignals::getSuccessResponse, this,
+		[this](QString path, QString value, QString timestamp) {
+			update(path, value);
+		});
+	connect(m_vs, &VehicleSignals::signalNotification, this,
+		[this](QString path, QString value, QString timestamp) {
+			update(path, value);
+		});
+
+	m_vs->connect();
+}
+
+VehicleSignalChannel *VehicleSignalHub::acquire(const QString &path)
+{
+	VehicleSignalChannel *&channel = m_channels[path];
+
+	if (!channel)
+		channel = new VehicleSignalChannel(path, this);
+
+	if (channel->m_refs++ == 0 && m_authorized && !channel->m_subscribed)
+		subscribe(channel);
+
+	return channel;
+}
+
+void VehicleSignalHub::release(VehicleSignalChannel *channel)
+{
+	if (channel && channel->m_refs > 0)
+		channel->m_refs--;
+}
+
+void VehicleSignalHub::subscribe(VehicleSignalChannel *channel)
+{
+	if (channel->m_subscribed)
+		return;
+
+	HMI_DEBUG("HomeScreen", "Subscribing to %s", qUtf8Printable(channel->m_path));
+
+	channel->m_subscribed = true;
+	m_vs->subscribe(channel->m_path);
+	m_vs->get(channel->m_path);
+}
+
+void VehicleSignalHub::set(const QString &path, const QString &value)
+{
+	if (!m_authorized)
+		return;
+
+	m_vs->set(path, value);
+}
+
+void VehicleSignalHub::update(const QString &path, const QString &value)
+{
+	VehicleSignalChannel *channel = m_channels.value(path);
+
+	if (!channel)
+		return;
+
+	channel->m_value = value;
+	channel->m_has_value = true;
+	emit channel->valueChanged(value);
+}
+
+VehicleSignalBinding::VehicleSignalBinding(QObject *parent) :
+	QObject(parent)
+{
+}
+
+VehicleSignalBinding::~VehicleSignalBinding()
+{
+	if (m_channel)
+		VehicleSignalHub::instance()->release(m_channel);
+}
+
+QString VehicleSignalBinding::path() const
+{
+	return m_channel ? m_channel->path() : QString();
+}
+
+void VehicleSignalBinding::setPath(const QString &path)
+{
+	VehicleSignalHub *hub = VehicleSignalHub::instance();
+	bool had_value = isValid();
+
+	if (path == this->path())
+		return;
+
+	if (m_channel) {
+		disconnect(m_channel, nullptr, this, nullptr);
+		hub->release(m_channel);
+		m_channel = nullptr;
+	}
+
+	if (!path.isEmpty()) {
+		m_channel = hub->acquire(path);
+		connect(m_channel, &VehicleSignalChannel::valueChanged,
+			this, &VehicleSignalBinding::valueChanged);
+	}
+
+	emit pathChanged();
+	if (had_value || isValid())
+		emit valueChanged();
+}
+
+QString VehicleSignalBinding::value() const
+{
+	return m_channel ? m_channel->value() : QString();
+}
+
+bool VehicleSignalBinding::isValid() const
+{
+	return m_channel && m_channel->hasValue();
+}
+
+void VehicleSignalBinding::set(const QString &value)
+{
+	if (m_channel)
+		m_channel->set(value);
+}
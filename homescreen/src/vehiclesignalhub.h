@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef VEHICLESIGNALHUB_H
+#define VEHICLESIGNALHUB_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+class VehicleSignals;
+class VehicleSignalHub;
+
+/*
+ * One VSS path of the hub. It holds the last value the broker reported,
+ * so a new consumer can read it right away instead of waiting for the
+ * next notification, and notifies every consumer of the path.
+ */
+class VehicleSignalChannel : public QObject
+{
+	Q_OBJECT
+public:
+	const QString &path() const { return m_path; }
+	bool hasValue() const { return m_has_value; }
+	const QString &value() const { return m_value; }
+
+	void set(const QString &value);
+
+signals:
+	void valueChanged(const QString &value);
+
+private:
+	friend class VehicleSignalHub;
+
+	VehicleSignalChannel(const QString &path, VehicleSignalHub *hub);
+
+	VehicleSignalHub *m_hub;
+	QString m_path;
+	QString m_value;
+	bool m_has_value = false;
+	int m_refs = 0;
+	bool m_subscribed = false;
+};
+
+/*
+ * The homescreen's single connection to the vehicle-signal broker, shared
+ * by everything that reads or writes a VSS path.
+ *
+ * Consumers acquire a channel per path and release it when done; a path is
+ * subscribed to, and its value fetched, when it is first acquired, and
+ * again after a reconnection for the paths still in use. The broker has no
+ * way to unsubscribe, so released paths stay subscribed and keep their
+ * last value, ready for the next consumer.
+ */
+class VehicleSignalHub : public QObject
+{
+	Q_OBJECT
+public:
+	static VehicleSignalHub *instance();
+
+	bool isAuthorized() const { return m_authorized; }
+
+	VehicleSignalChannel *acquire(const QString &path);
+	void release(VehicleSignalChannel *channel);
+
+	/* dropped unless authorized, as the broker would */
+	void set(const QString &path, const QString &value);
+
+signals:
+	void authorizedChanged(bool authorized);
+
+private:
+	explicit VehicleSignalHub(QObject *parent = nullptr);
+
+	void subscribe(VehicleSignalChannel *channel);
+	void update(const QString &path, const QString &value);
+
+	VehicleSignals *m_vs;
+	bool m_authorized = false;
+	QHash<QString, VehicleSignalChannel *> m_channels;
+};
+
+/*
+ * A VSS path for QML, through the hub:
+ *
+ *   VehicleSignal {
+ *       path: "Vehicle.Speed"
+ *       onValueChanged: speed.text = value
+ *   }
+ */
+class VehicleSignalBinding : public QObject
+{
+	Q_OBJECT
+	Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+	Q_PROPERTY(QString value READ value NOTIFY valueChanged)
+	Q_PROPERTY(bool valid READ isValid NOTIFY valueChanged)
+
+public:
+	explicit VehicleSignalBinding(QObject *parent = nullptr);
+	~VehicleSignalBinding();
+
+	QString path() const;
+	void setPath(const QString &path);
+
+	QString value() const;
+	bool isValid() const;
+
+	Q_INVOKABLE void set(const QString &value);
+
+signals:
+	void pathChanged();
+	void valueChanged();
+
+private:
+	// gone with the hub when the application exits
+	QPointer<VehicleSignalChannel> m_channel;
+};
+
+#endif // VEHICLESIGNALHUB_H
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "wallclock.h"
+
+#define LOCALTIME_DIR	"/etc"
+
+WallClock::WallClock(QObject *parent) :
+	QObject(parent)
+{
+	m_fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+	if (m_fd >= 0) {
+		m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+		connect(m_notifier, &QSocketNotifier::activated,
+			this, &WallClock::timerExpired);
+	} else {
+		qWarning() << "timerfd_create failed:" << strerror(errno)
+			   << "- falling back to a QTimer";
+		m_fallback = new QTimer(this);
+		m_fallback->setSingleShot(true);
+		m_fallback->setTimerType(Qt::PreciseTimer);
+		connect(m_fallback, &QTimer::timeout, this, [this]() {
+			update();
+			arm();
+		});
+	}
+
+	// timedatectl replaces the /etc/localtime symlink, which only
+	// shows up as a change of the directory
+	m_zone_watcher = new QFileSystemWatcher(this);
+	m_zone_watcher->addPath(QStringLiteral(LOCALTIME_DIR));
+	connect(m_zone_watcher, &QFileSystemWatcher::directoryChanged,
+		this, [this]() { tzset(); update(); });
+
+	update();
+	arm();
+}
+
+WallClock::~WallClock()
+{
+	if (m_fd >= 0)
+		close(m_fd);
+}
+
+void WallClock::arm()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	if (m_fd < 0) {
+		qint64 ms = (60 - now.tv_sec % 60) * 1000 - now.tv_nsec / 1000000;
+		m_fallback->start(ms > 0 ? ms : 1);
+		return;
+	}
+
+	struct itimerspec its = {};
+	its.it_value.tv_sec = now.tv_sec - now.tv_sec % 60 + 60;
+
+	if (timerfd_settime(m_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET,
+			    &its, nullptr) < 0)
+		qWarning() << "timerfd_settime failed:" << strerror(errno);
+}
+
+void WallClock::timerExpired()
+{
+	uint64_t expirations;
+
+	// ECANCELED means the clock was set; either way the time is
+	// re-read and the timer re-armed for the next minute boundary
+	if (read(m_fd, &expirations, sizeof(expirations)) < 0 &&
+	    errno != ECANCELED && errno != EAGAIN)
+		qWarning() << "reading the clock timer failed:" << strerror(errno);
+
+	update();
+	arm();
+}
+
+void WallClock::update()
+{
+	QDateTime now = QDateTime::currentDateTime();
+	QString day = now.toString(QStringLiteral("dddd")).toUpper();
+	QString time = now.toString(QStringLiteral("h:mm ap")).toUpper();
+
+	if (day == m_day && time == m_time)
+		return;
+
+	m_day = day;
+	m_time = time;
+	emit changed();
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef WALLCLOCK_H
+#define WALLCLOCK_H
+
+#include <QObject>
+#include <QString>
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+class QTimer;
+
+/*
+ * Wall clock for the status area, which only displays minutes.
+ *
+ * A CLOCK_REALTIME timerfd is armed for the next minute boundary, in
+ * absolute time, so the GUI thread wakes up once a minute. The timer is
+ * cancelled by the kernel whenever the clock is set (NTP, manual change),
+ * and /etc is watched for a replaced /etc/localtime, so both kinds of jump
+ * show up straight away. QML gets the strings already formatted, and
+ * changed() is only emitted when one of them actually changes.
+ */
+class WallClock : public QObject
+{
+	Q_OBJECT
+	Q_PROPERTY(QString day READ day NOTIFY changed)
+	Q_PROPERTY(QString time READ time NOTIFY changed)
+
+public:
+	explicit WallClock(QObject *parent = nullptr);
+	~WallClock();
+
+	QString day() const { return m_day; }
+	QString time() const { return m_time; }
+
+signals:
+	void changed();
+
+private:
+	void timerExpired();
+	void arm();
+	void update();
+
+	int m_fd = -1;
+	QSocketNotifier *m_notifier = nullptr;
+	QTimer *m_fallback = nullptr;
+	QFileSystemWatcher *m_zone_watcher = nullptr;
+	QString m_day;
+	QString m_time;
+};
+
+#endif // WALLCLOCK_H
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Converts a background image to the raw, pre-scaled format read by
+ * BackgroundImageProvider, see src/rawimage.h.
+ *
+ * Usage: bgconvert <input> <width>x<height> <output>
+ *
+ * The image is stretched to the given size, like an Image item with the
+ * default fill mode would do.
+ */
+
+#include <QFile>
+#include <QImage>
+#include <QString>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rawimage.h"
+
+int main(int argc, char *argv[])
+{
+	struct raw_image_header header;
+	static const char padding[RAW_IMAGE_DATA_OFFSET] = {};
+	int width, height;
+
+	if (argc != 4 || sscanf(argv[2], "%dx%d", &width, &height) != 2 ||
+	    width <= 0 || height <= 0) {
+		fprintf(stderr, "Usage: %s <input> <width>x<height> <output>\n", argv[0]);
+		return 1;
+	}
+
+	QImage image(QString::fromLocal8Bit(argv[1]));
+	if (image.isNull()) {
+		fprintf(stderr, "Unable to read %s\n", argv[1]);
+		return 1;
+	}
+
+	image = image.scaled(width, height, Qt::IgnoreAspectRatio,
+			     Qt::SmoothTransformation);
+	image = image.convertToFormat(image.hasAlphaChannel() ?
+				      QImage::Format_ARGB32_Premultiplied :
+				      QImage::Format_RGB32);
+
+	memset(&header, 0, sizeof(header));
+	header.magic = RAW_IMAGE_MAGIC;
+	header.version = RAW_IMAGE_VERSION;
+	header.width = image.width();
+	header.height = image.height();
+	header.stride = image.bytesPerLine();
+	header.format = image.format();
+	header.data_offset = RAW_IMAGE_DATA_OFFSET;
+
+	QFile out(QString::fromLocal8Bit(argv[3]));
+	if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		fprintf(stderr, "Unable to write %s\n", argv[3]);
+		return 1;
+	}
+
+	out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.write(padding, RAW_IMAGE_DATA_OFFSET - sizeof(header));
+	for (int y = 0; y < image.height(); y++)
+		out.write(reinterpret_cast<const char *>(image.constScanLine(y)),
+			  image.bytesPerLine());
+
+	if (!out.flush() || out.error() != QFileDevice::NoError) {
+		fprintf(stderr, "Unable to write %s\n", argv[3]);
+		return 1;
+	}
+
+	return 0;
+}
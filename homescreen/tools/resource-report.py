@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+#
+# Lists every file of the given .qrc resource files with what it costs: its
+# size on disk, what zlib gets it down to (what rcc would store when it
+# compresses it), and for PNGs the memory it takes once decoded. Files that
+# don't seem to be referenced from any QML or C++ source are flagged as
+# unused.
+
+import argparse
+import os
+import struct
+import sys
+import xml.etree.ElementTree as ET
+import zlib
+
+
+def png_decoded_size(path):
+    with open(path, 'rb') as f:
+        header = f.read(24)
+    if len(header) < 24 or header[:8] != b'\x89PNG\r\n\x1a\n':
+        return None
+    width, height = struct.unpack('>II', header[16:24])
+    # decoded into 32-bit ARGB
+    return width * height * 4
+
+
+def qrc_files(qrc):
+    base = os.path.dirname(qrc)
+    for resource in ET.parse(qrc).getroot().iter('qresource'):
+        prefix = resource.get('prefix', '/').rstrip('/')
+        for node in resource.iter('file'):
+            alias = node.get('alias', node.text)
+            yield (os.path.join(base, node.text), prefix + '/' + alias)
+
+
+def read_sources(source_dirs):
+    sources = ''
+    for source_dir in source_dirs:
+        for root, _, files in os.walk(source_dir):
+            for name in files:
+                if name.endswith(('.qml', '.cpp', '.h')):
+                    with open(os.path.join(root, name), encoding='utf-8') as f:
+                        sources += f.read()
+    return sources
+
+
+def is_referenced(resource, sources):
+    if resource.endswith('.qml'):
+        return True
+    # either the file, with or without extension (image providers), or its
+    # directory in a templated path such as './images/Shortcut/%1.svg'
+    directory, name = os.path.split(resource.lstrip('/'))
+    return os.path.splitext(name)[0] in sources or \
+        directory + '/%' in sources
+
+
+def human(size):
+    if size is None:
+        return '-'
+    for unit in ['B', 'KiB', 'MiB']:
+        if size < 1024 or unit == 'MiB':
+            return '%.1f %s' % (size, unit) if unit != 'B' else '%d B' % size
+        size /= 1024.0
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--source-dir', action='append', default=[],
+                        help='flag files not used by the sources in this directory')
+    parser.add_argument('qrc', nargs='+')
+    args = parser.parse_args()
+
+    sources = read_sources(args.source_dir) if args.source_dir else None
+    rows = []
+    for qrc in args.qrc:
+        for path, resource in qrc_files(qrc):
+            with open(path, 'rb') as f:
+                data = f.read()
+            decoded = png_decoded_size(path) if path.endswith('.png') else None
+            unused = sources is not None and not is_referenced(resource, sources)
+            rows.append((resource, len(data), len(zlib.compress(data, 9)),
+                         decoded, unused))
+
+    rows.sort(key=lambda row: row[1], reverse=True)
+    print('%-62s %10s %10s %10s' % ('resource', 'disk', 'zlib', 'decoded'))
+    for resource, size, compressed, decoded, unused in rows:
+        print('%-62s %10s %10s %10s%s' % (':' + resource, human(size),
+                                          human(compressed), human(decoded),
+                                          '  unused' if unused else ''))
+
+    print('%-62s %10s %10s %10s' % (
+        'total', human(sum(r[1] for r in rows)), human(sum(r[2] for r in rows)),
+        human(sum(r[3] or 0 for r in rows))))
+    print('%-62s %10s' % ('unused', human(sum(r[1] for r in rows if r[4]))))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
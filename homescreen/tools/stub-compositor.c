@@ -0,0 +1,869 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * A stand-in for agl-compositor, good enough to run the homescreen against
+ * on a machine without one, and to benchmark its protocol handling.
+ *
+ * It implements wl_compositor, wl_shm, wl_shell and a single wl_output,
+ * none of which show anything, and agl_shell: it answers the bind with
+ * bound_ok, accepts set_background/set_panel/activate_app/ready, and
+ * answers activate_app the way the compositor does, with
+ * DEACTIVATED/ACTIVATED app_state events.
+ *
+ * A script drives the rest, one command per line:
+ *
+ *   wait_ready              wait for agl_shell.ready
+ *   sleep <ms>              let the client run for a while
+ *   started <app_id>        app_state STARTED, likewise terminated,
+ *                           activated and deactivated
+ *   on_output <app_id> <output>
+ *                           app_on_output
+ *   loop <n> ... endloop    repeat the commands in between n times
+ *   quit                    stop the client and exit
+ *
+ * At exit it prints the time the client took to send ready, and the time
+ * between each STARTED event and the activate_app it caused.
+ *
+ * The client is started with WAYLAND_DISPLAY pointing at the stub, the
+ * wl-shell shell integration and the software Quick backend.
+ *
+ * Usage: stub-compositor [-s script] [-m WxH] [-n output name] [-- client...]
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <wayland-server.h>
+
+#include "agl-shell-server-protocol.h"
+
+#define MAX_PENDING_STARTS	64
+
+struct pending_start {
+	char *app_id;
+	uint64_t sent_us;
+};
+
+struct stub {
+	struct wl_display *display;
+	struct wl_event_loop *loop;
+	bool running;
+
+	int width, height;
+	const char *output_name;
+
+	struct wl_resource *shell;
+	char *active_app;
+	uint64_t spawned_us;
+	uint64_t ready_us;
+
+	char **script;
+	size_t script_len;
+	size_t pc;
+	size_t loop_start;
+	long loop_left;
+	bool waiting_ready;
+	struct wl_event_source *script_timer;
+
+	struct pending_start starts[MAX_PENDING_STARTS];
+	unsigned activations, backgrounds, panels, events_sent;
+	unsigned latency_count;
+	uint64_t latency_sum_us, latency_max_us;
+
+	pid_t child;
+	int exit_code;
+};
+
+struct stub_surface {
+	struct wl_resource *resource;
+	struct wl_resource *buffer;
+	struct wl_listener buffer_destroy;
+	struct wl_list frame_callbacks;
+};
+
+static uint64_t
+now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void run_script(struct stub *stub);
+
+/* wl_region */
+
+static void
+resource_destroy(struct wl_client *client, struct wl_resource *resource)
+{
+	wl_resource_destroy(resource);
+}
+
+static void
+region_add(struct wl_client *client, struct wl_resource *resource,
+	   int32_t x, int32_t y, int32_t width, int32_t height)
+{
+}
+
+static const struct wl_region_interface region_impl = {
+	.destroy = resource_destroy,
+	.add = region_add,
+	.subtract = region_add,
+};
+
+/* wl_surface */
+
+static void
+surface_buffer_destroyed(struct wl_listener *listener, void *data)
+{
+	struct stub_surface *surface =
+		wl_container_of(listener, surface, buffer_destroy);
+
+	surface->buffer = NULL;
+	wl_list_remove(&listener->link);
+	wl_list_init(&listener->link);
+}
+
+static void
+surface_set_buffer(struct stub_surface *surface, struct wl_resource *buffer)
+{
+	wl_list_remove(&surface->buffer_destroy.link);
+	wl_list_init(&surface->buffer_destroy.link);
+
+	surface->buffer = buffer;
+	if (buffer)
+		wl_resource_add_destroy_listener(buffer, &surface->buffer_destroy);
+}
+
+static void
+surface_attach(struct wl_client *client, struct wl_resource *resource,
+	       struct wl_resource *buffer, int32_t x, int32_t y)
+{
+	struct stub_surface *surface = wl_resource_get_user_data(resource);
+
+	surface_set_buffer(surface, buffer);
+}
+
+static void
+surface_damage(struct wl_client *client, struct wl_resource *resource,
+	       int32_t x, int32_t y, int32_t width, int32_t height)
+{
+}
+
+static void
+callback_destroyed(struct wl_resource *resource)
+{
+	wl_list_remove(wl_resource_get_link(resource));
+}
+
+static void
+surface_frame(struct wl_client *client, struct wl_resource *resource,
+	      uint32_t callback)
+{
+	struct stub_surface *surface = wl_resource_get_user_data(resource);
+	struct wl_resource *cb;
+
+	cb = wl_resource_create(client, &wl_callback_interface, 1, callback);
+	if (!cb) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(cb, NULL, NULL, callback_destroyed);
+	wl_list_insert(surface->frame_callbacks.prev, wl_resource_get_link(cb));
+}
+
+static void
+surface_set_region(struct wl_client *client, struct wl_resource *resource,
+		   struct wl_resource *region)
+{
+}
+
+/* nothing is shown: buffers go back and frames are done straight away */
+static void
+surface_commit(struct wl_client *client, struct wl_resource *resource)
+{
+	struct stub_surface *surface = wl_resource_get_user_data(resource);
+	uint32_t time_ms = now_usec() / 1000;
+	struct wl_resource *cb, *tmp;
+
+	if (surface->buffer) {
+		wl_buffer_send_release(surface->buffer);
+		surface_set_buffer(surface, NULL);
+	}
+
+	wl_resource_for_each_safe(cb, tmp, &surface->frame_callbacks) {
+		wl_callback_send_done(cb, time_ms);
+		wl_resource_destroy(cb);
+	}
+}
+
+static void
+surface_set_int(struct wl_client *client, struct wl_resource *resource,
+		int32_t value)
+{
+}
+
+static const struct wl_surface_interface surface_impl = {
+	.destroy = resource_destroy,
+	.attach = surface_attach,
+	.damage = surface_damage,
+	.frame = surface_frame,
+	.set_opaque_region = surface_set_region,
+	.set_input_region = surface_set_region,
+	.commit = surface_commit,
+	.set_buffer_transform = surface_set_int,
+	.set_buffer_scale = surface_set_int,
+	.damage_buffer = surface_damage,
+};
+
+static void
+surface_destroyed(struct wl_resource *resource)
+{
+	struct stub_surface *surface = wl_resource_get_user_data(resource);
+	struct wl_resource *cb, *tmp;
+
+	wl_list_remove(&surface->buffer_destroy.link);
+	wl_resource_for_each_safe(cb, tmp, &surface->frame_callbacks)
+		wl_resource_destroy(cb);
+	free(surface);
+}
+
+/* wl_compositor */
+
+static void
+compositor_create_surface(struct wl_client *client, struct wl_resource *resource,
+			  uint32_t id)
+{
+	struct stub_surface *surface = calloc(1, sizeof(*surface));
+
+	if (!surface) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	surface->resource = wl_resource_create(client, &wl_surface_interface,
+					       wl_resource_get_version(resource), id);
+	if (!surface->resource) {
+		free(surface);
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_list_init(&surface->frame_callbacks);
+	wl_list_init(&surface->buffer_destroy.link);
+	surface->buffer_destroy.notify = surface_buffer_destroyed;
+	wl_resource_set_implementation(surface->resource, &surface_impl,
+				       surface, surface_destroyed);
+}
+
+static void
+compositor_create_region(struct wl_client *client, struct wl_resource *resource,
+			 uint32_t id)
+{
+	struct wl_resource *region;
+
+	region = wl_resource_create(client, &wl_region_interface, 1, id);
+	if (!region) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(region, &region_impl, NULL, NULL);
+}
+
+static const struct wl_compositor_interface compositor_impl = {
+	.create_surface = compositor_create_surface,
+	.create_region = compositor_create_region,
+};
+
+static void
+bind_compositor(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+	struct wl_resource *resource;
+
+	resource = wl_resource_create(client, &wl_compositor_interface, version, id);
+	if (!resource) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(resource, &compositor_impl, data, NULL);
+}
+
+/* wl_output */
+
+static const struct wl_output_interface output_impl = {
+	.release = resource_destroy,
+};
+
+static void
+bind_output(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+	struct stub *stub = data;
+	struct wl_resource *resource;
+
+	resource = wl_resource_create(client, &wl_output_interface, version, id);
+	if (!resource) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(resource, &output_impl, stub, NULL);
+
+	wl_output_send_geometry(resource, 0, 0, stub->width / 4, stub->height / 4,
+				WL_OUTPUT_SUBPIXEL_UNKNOWN, "AGL", stub->output_name,
+				WL_OUTPUT_TRANSFORM_NORMAL);
+	wl_output_send_mode(resource, WL_OUTPUT_MODE_CURRENT | WL_OUTPUT_MODE_PREFERRED,
+			    stub->width, stub->height, 60000);
+	if (version >= WL_OUTPUT_SCALE_SINCE_VERSION)
+		wl_output_send_scale(resource, 1);
+#ifdef WL_OUTPUT_NAME_SINCE_VERSION
+	if (version >= WL_OUTPUT_NAME_SINCE_VERSION)
+		wl_output_send_name(resource, stub->output_name);
+#endif
+	if (version >= WL_OUTPUT_DONE_SINCE_VERSION)
+		wl_output_send_done(resource);
+}
+
+/* wl_shell, which Qt uses with QT_WAYLAND_SHELL_INTEGRATION=wl-shell */
+
+static void
+shell_surface_pong(struct wl_client *client, struct wl_resource *resource,
+		   uint32_t serial)
+{
+}
+
+static void
+shell_surface_move(struct wl_client *client, struct wl_resource *resource,
+		   struct wl_resource *seat, uint32_t serial)
+{
+}
+
+static void
+shell_surface_resize(struct wl_client *client, struct wl_resource *resource,
+		     struct wl_resource *seat, uint32_t serial, uint32_t edges)
+{
+}
+
+static void
+shell_surface_set_toplevel(struct wl_client *client, struct wl_resource *resource)
+{
+}
+
+static void
+shell_surface_set_transient(struct wl_client *client, struct wl_resource *resource,
+			    struct wl_resource *parent, int32_t x, int32_t y,
+			    uint32_t flags)
+{
+}
+
+static void
+shell_surface_set_fullscreen(struct wl_client *client, struct wl_resource *resource,
+			     uint32_t method, uint32_t framerate,
+			     struct wl_resource *output)
+{
+}
+
+static void
+shell_surface_set_popup(struct wl_client *client, struct wl_resource *resource,
+			struct wl_resource *seat, uint32_t serial,
+			struct wl_resource *parent, int32_t x, int32_t y,
+			uint32_t flags)
+{
+}
+
+static void
+shell_surface_set_maximized(struct wl_client *client, struct wl_resource *resource,
+			    struct wl_resource *output)
+{
+}
+
+static void
+shell_surface_set_string(struct wl_client *client, struct wl_resource *resource,
+			 const char *value)
+{
+}
+
+static const struct wl_shell_surface_interface shell_surface_impl = {
+	.pong = shell_surface_pong,
+	.move = shell_surface_move,
+	.resize = shell_surface_resize,
+	.set_toplevel = shell_surface_set_toplevel,
+	.set_transient = shell_surface_set_transient,
+	.set_fullscreen = shell_surface_set_fullscreen,
+	.set_popup = shell_surface_set_popup,
+	.set_maximized = shell_surface_set_maximized,
+	.set_title = shell_surface_set_string,
+	.set_class = shell_surface_set_string,
+};
+
+static void
+shell_get_shell_surface(struct wl_client *client, struct wl_resource *resource,
+			uint32_t id, struct wl_resource *surface)
+{
+	struct wl_resource *shell_surface;
+
+	shell_surface = wl_resource_create(client, &wl_shell_surface_interface, 1, id);
+	if (!shell_surface) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(shell_surface, &shell_surface_impl, NULL, NULL);
+}
+
+static const struct wl_shell_interface shell_impl = {
+	.get_shell_surface = shell_get_shell_surface,
+};
+
+static void
+bind_shell(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+	struct wl_resource *resource;
+
+	resource = wl_resource_create(client, &wl_shell_interface, 1, id);
+	if (!resource) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(resource, &shell_impl, data, NULL);
+}
+
+/* agl_shell */
+
+static void
+send_app_state(struct stub *stub, const char *app_id, uint32_t state)
+{
+	if (!stub->shell ||
+	    wl_resource_get_version(stub->shell) < AGL_SHELL_APP_STATE_SINCE_VERSION)
+		return;
+
+	agl_shell_send_app_state(stub->shell, app_id, state);
+	stub->events_sent++;
+}
+
+static void
+record_start(struct stub *stub, const char *app_id)
+{
+	struct pending_start *slot = NULL;
+
+	for (int i = 0; i < MAX_PENDING_STARTS; i++) {
+		struct pending_start *ps = &stub->starts[i];
+
+		if (ps->app_id && strcmp(ps->app_id, app_id) == 0) {
+			slot = ps;
+			break;
+		}
+		if (!ps->app_id && !slot)
+			slot = ps;
+	}
+
+	if (!slot)
+		return;
+
+	if (!slot->app_id)
+		slot->app_id = strdup(app_id);
+	slot->sent_us = now_usec();
+}
+
+static void
+record_activation(struct stub *stub, const char *app_id)
+{
+	for (int i = 0; i < MAX_PENDING_STARTS; i++) {
+		struct pending_start *ps = &stub->starts[i];
+		uint64_t latency;
+
+		if (!ps->app_id || strcmp(ps->app_id, app_id) != 0)
+			continue;
+
+		latency = now_usec() - ps->sent_us;
+		stub->latency_count++;
+		stub->latency_sum_us += latency;
+		if (latency > stub->latency_max_us)
+			stub->latency_max_us = latency;
+
+		free(ps->app_id);
+		ps->app_id = NULL;
+		return;
+	}
+}
+
+static void
+shell_ready(struct wl_client *client, struct wl_resource *resource)
+{
+	struct stub *stub = wl_resource_get_user_data(resource);
+
+	if (!stub->ready_us)
+		stub->ready_us = now_usec();
+
+	if (stub->waiting_ready) {
+		stub->waiting_ready = false;
+		run_script(stub);
+	}
+}
+
+static void
+shell_set_background(struct wl_client *client, struct wl_resource *resource,
+		     struct wl_resource *surface, struct wl_resource *output)
+{
+	struct stub *stub = wl_resource_get_user_data(resource);
+
+	stub->backgrounds++;
+}
+
+static void
+shell_set_panel(struct wl_client *client, struct wl_resource *resource,
+		struct wl_resource *surface, struct wl_resource *output,
+		uint32_t edge)
+{
+	struct stub *stub = wl_resource_get_user_data(resource);
+
+	stub->panels++;
+}
+
+static void
+shell_activate_app(struct wl_client *client, struct wl_resource *resource,
+		   const char *app_id, struct wl_resource *output)
+{
+	struct stub *stub = wl_resource_get_user_data(resource);
+
+	stub->activations++;
+	record_activation(stub, app_id);
+
+	if (stub->active_app && strcmp(stub->active_app, app_id) == 0)
+		return;
+
+	if (stub->active_app) {
+		send_app_state(stub, stub->active_app, AGL_SHELL_APP_STATE_DEACTIVATED);
+		free(stub->active_app);
+	}
+	stub->active_app = strdup(app_id);
+	send_app_state(stub, app_id, AGL_SHELL_APP_STATE_ACTIVATED);
+}
+
+#ifdef AGL_SHELL_SET_ACTIVATE_REGION_SINCE_VERSION
+static void
+shell_set_activate_region(struct wl_client *client, struct wl_resource *resource,
+			  struct wl_resource *output, int32_t x, int32_t y,
+			  int32_t width, int32_t height)
+{
+}
+#endif
+
+/* requests the homescreen never sends are left unimplemented */
+static const struct agl_shell_interface agl_shell_impl = {
+	.ready = shell_ready,
+	.set_background = shell_set_background,
+	.set_panel = shell_set_panel,
+	.activate_app = shell_activate_app,
+#ifdef AGL_SHELL_DESTROY_SINCE_VERSION
+	.destroy = resource_destroy,
+#endif
+#ifdef AGL_SHELL_SET_ACTIVATE_REGION_SINCE_VERSION
+	.set_activate_region = shell_set_activate_region,
+#endif
+};
+
+static void
+shell_destroyed(struct wl_resource *resource)
+{
+	struct stub *stub = wl_resource_get_user_data(resource);
+
+	if (stub->shell == resource)
+		stub->shell = NULL;
+}
+
+static void
+bind_agl_shell(struct wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+	struct stub *stub = data;
+	struct wl_resource *resource;
+
+	resource = wl_resource_create(client, &agl_shell_interface, version, id);
+	if (!resource) {
+		wl_client_post_no_memory(client);
+		return;
+	}
+
+	wl_resource_set_implementation(resource, &agl_shell_impl, stub, shell_destroyed);
+
+	if (stub->shell) {
+		if (version >= AGL_SHELL_BOUND_FAIL_SINCE_VERSION)
+			agl_shell_send_bound_fail(resource);
+		return;
+	}
+
+	stub->shell = resource;
+	if (version >= AGL_SHELL_BOUND_OK_SINCE_VERSION)
+		agl_shell_send_bound_ok(resource);
+}
+
+/* script */
+
+static bool
+load_script(struct stub *stub, const char *path)
+{
+	FILE *f = fopen(path, "r");
+	char *line = NULL;
+	size_t cap = 0;
+	ssize_t len;
+
+	if (!f) {
+		fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+		return false;
+	}
+
+	while ((len = getline(&line, &cap, f)) >= 0) {
+		char *start = line;
+
+		while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == ' '))
+			line[--len] = '\0';
+		while (*start == ' ' || *start == '\t')
+			start++;
+		if (*start == '\0' || *start == '#')
+			continue;
+
+		stub->script = realloc(stub->script,
+				       (stub->script_len + 1) * sizeof(char *));
+		stub->script[stub->script_len++] = strdup(start);
+	}
+
+	free(line);
+	fclose(f);
+	return true;
+}
+
+static int
+script_timer_fired(void *data)
+{
+	run_script(data);
+	return 0;
+}
+
+static void
+stop(struct stub *stub)
+{
+	if (stub->child > 0)
+		kill(stub->child, SIGTERM);
+	else
+		stub->running = false;
+}
+
+static void
+run_script(struct stub *stub)
+{
+	char cmd[32], arg1[256], arg2[256];
+
+	while (stub->pc < stub->script_len) {
+		const char *line = stub->script[stub->pc++];
+		int n = sscanf(line, "%31s %255s %255s", cmd, arg1, arg2);
+
+		if (strcmp(cmd, "wait_ready") == 0) {
+			if (!stub->ready_us) {
+				stub->waiting_ready = true;
+				return;
+			}
+		} else if (strcmp(cmd, "sleep") == 0 && n >= 2) {
+			wl_event_source_timer_update(stub->script_timer,
+						     atoi(arg1) > 0 ? atoi(arg1) : 1);
+			return;
+		} else if (strcmp(cmd, "started") == 0 && n >= 2) {
+			record_start(stub, arg1);
+			send_app_state(stub, arg1, AGL_SHELL_APP_STATE_STARTED);
+		} else if (strcmp(cmd, "terminated") == 0 && n >= 2) {
+			send_app_state(stub, arg1, AGL_SHELL_APP_STATE_TERMINATED);
+		} else if (strcmp(cmd, "activated") == 0 && n >= 2) {
+			send_app_state(stub, arg1, AGL_SHELL_APP_STATE_ACTIVATED);
+		} else if (strcmp(cmd, "deactivated") == 0 && n >= 2) {
+			send_app_state(stub, arg1, AGL_SHELL_APP_STATE_DEACTIVATED);
+		} else if (strcmp(cmd, "on_output") == 0 && n >= 3) {
+#ifdef AGL_SHELL_APP_ON_OUTPUT_SINCE_VERSION
+			if (stub->shell &&
+			    wl_resource_get_version(stub->shell) >= AGL_SHELL_APP_ON_OUTPUT_SINCE_VERSION) {
+				agl_shell_send_app_on_output(stub->shell, arg1, arg2);
+				stub->events_sent++;
+			}
+#endif
+		} else if (strcmp(cmd, "loop") == 0 && n >= 2) {
+			stub->loop_start = stub->pc;
+			stub->loop_left = atol(arg1);
+		} else if (strcmp(cmd, "endloop") == 0) {
+			if (--stub->loop_left > 0)
+				stub->pc = stub->loop_start;
+		} else if (strcmp(cmd, "quit") == 0) {
+			stop(stub);
+			return;
+		} else {
+			fprintf(stderr, "Ignoring script line '%s'\n", line);
+		}
+	}
+}
+
+/* client */
+
+static int
+child_exited(int signal_number, void *data)
+{
+	struct stub *stub = data;
+	int status;
+
+	if (stub->child <= 0 || waitpid(stub->child, &status, WNOHANG) != stub->child)
+		return 0;
+
+	stub->child = 0;
+	stub->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+	stub->running = false;
+	return 0;
+}
+
+static int
+interrupted(int signal_number, void *data)
+{
+	stop(data);
+	return 0;
+}
+
+static bool
+spawn(struct stub *stub, const char *socket, char **argv)
+{
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		perror("fork");
+		return false;
+	}
+
+	if (pid == 0) {
+		sigset_t none;
+
+		/* the event loop blocks the signals it handles */
+		sigemptyset(&none);
+		sigprocmask(SIG_SETMASK, &none, NULL);
+
+		setenv("WAYLAND_DISPLAY", socket, 1);
+		setenv("QT_WAYLAND_SHELL_INTEGRATION", "wl-shell", 0);
+		setenv("QT_QUICK_BACKEND", "software", 0);
+		execvp(argv[0], argv);
+		fprintf(stderr, "Unable to run %s: %s\n", argv[0], strerror(errno));
+		_exit(127);
+	}
+
+	stub->child = pid;
+	stub->spawned_us = now_usec();
+	return true;
+}
+
+static void
+print_summary(struct stub *stub)
+{
+	printf("surfaces: %u background, %u panel\n", stub->backgrounds, stub->panels);
+	if (stub->ready_us && stub->spawned_us)
+		printf("time to ready: %.1f ms\n",
+		       (stub->ready_us - stub->spawned_us) / 1000.0);
+	printf("events sent: %u, activate_app received: %u\n",
+	       stub->events_sent, stub->activations);
+	if (stub->latency_count)
+		printf("STARTED -> activate_app: %u, avg %.2f ms, max %.2f ms\n",
+		       stub->latency_count,
+		       stub->latency_sum_us / 1000.0 / stub->latency_count,
+		       stub->latency_max_us / 1000.0);
+}
+
+static void
+usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-s script] [-m WxH] [-n output name] [-- client...]\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+	struct stub stub = {
+		.running = true,
+		.width = 1080,
+		.height = 1920,
+		.output_name = "stub-1",
+	};
+	const char *script = NULL;
+	const char *socket;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:m:n:h")) != -1) {
+		switch (opt) {
+		case 's':
+			script = optarg;
+			break;
+		case 'm':
+			if (sscanf(optarg, "%dx%d", &stub.width, &stub.height) != 2) {
+				usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'n':
+			stub.output_name = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (script && !load_script(&stub, script))
+		return EXIT_FAILURE;
+
+	stub.display = wl_display_create();
+	stub.loop = wl_display_get_event_loop(stub.display);
+
+	socket = wl_display_add_socket_auto(stub.display);
+	if (!socket) {
+		fprintf(stderr, "Unable to add a Wayland socket: %s\n", strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	wl_display_init_shm(stub.display);
+	wl_global_create(stub.display, &wl_compositor_interface, 4, &stub, bind_compositor);
+	wl_global_create(stub.display, &wl_output_interface,
+			 wl_output_interface.version, &stub, bind_output);
+	wl_global_create(stub.display, &wl_shell_interface, 1, &stub, bind_shell);
+	wl_global_create(stub.display, &agl_shell_interface,
+			 agl_shell_interface.version, &stub, bind_agl_shell);
+
+	stub.script_timer = wl_event_loop_add_timer(stub.loop, script_timer_fired, &stub);
+	wl_event_loop_add_signal(stub.loop, SIGCHLD, child_exited, &stub);
+	wl_event_loop_add_signal(stub.loop, SIGINT, interrupted, &stub);
+	wl_event_loop_add_signal(stub.loop, SIGTERM, interrupted, &stub);
+
+	if (optind < argc) {
+		if (!spawn(&stub, socket, &argv[optind]))
+			return EXIT_FAILURE;
+	} else {
+		printf("listening on %s\n", socket);
+		fflush(stdout);
+	}
+
+	run_script(&stub);
+
+	while (stub.running) {
+		wl_display_flush_clients(stub.display);
+		if (wl_event_loop_dispatch(stub.loop, -1) < 0 && errno != EINTR)
+			break;
+	}
+
+	print_summary(&stub);
+
+	wl_display_destroy_clients(stub.display);
+	wl_display_destroy(stub.display);
+
+	return stub.exit_code;
+}
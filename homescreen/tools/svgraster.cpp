@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Rasterizes SVG images at build time, the same way the SVG image plugin
+ * would at runtime, and writes a .qrc file listing the rasters.
+ *
+ * Usage: svgraster <output.qrc> <source root> <dpr>[,<dpr>...] <svg>...
+ *
+ * Each SVG is rendered at its own size times each device pixel ratio to
+ * <path relative to source root>.png for a ratio of 1 and to
+ * <path>@<dpr>x.png otherwise, next to the .qrc file. The rasters are listed
+ * under the /raster prefix, with the same path as the SVG they come from.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QStringList>
+#include <QSvgRenderer>
+#include <QTextStream>
+
+#include <stdio.h>
+
+int main(int argc, char *argv[])
+{
+	QList<int> dprs;
+
+	if (argc < 5) {
+		fprintf(stderr, "Usage: %s <output.qrc> <source root> "
+			"<dpr>[,<dpr>...] <svg>...\n", argv[0]);
+		return 1;
+	}
+
+	QFileInfo qrc_info(QString::fromLocal8Bit(argv[1]));
+	QDir output_dir = qrc_info.absoluteDir();
+	QDir source_root(QString::fromLocal8Bit(argv[2]));
+
+	for (const QString &dpr : QString::fromLocal8Bit(argv[3]).split(QLatin1Char(','))) {
+		bool ok;
+		int val = dpr.toInt(&ok);
+
+		if (!ok || val < 1) {
+			fprintf(stderr, "Invalid device pixel ratio %s\n", qPrintable(dpr));
+			return 1;
+		}
+		dprs << val;
+	}
+
+	QFile qrc(qrc_info.absoluteFilePath());
+	if (!qrc.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		fprintf(stderr, "Unable to write %s\n", argv[1]);
+		return 1;
+	}
+
+	QTextStream out(&qrc);
+	out << "<RCC>\n    <qresource prefix=\"/raster\">\n";
+
+	for (int i = 4; i < argc; i++) {
+		QString svg = QString::fromLocal8Bit(argv[i]);
+		QString base = source_root.relativeFilePath(QFileInfo(svg).absoluteFilePath());
+		QSvgRenderer renderer(svg);
+
+		if (!renderer.isValid() || renderer.defaultSize().isEmpty()) {
+			fprintf(stderr, "Unable to render %s\n", argv[i]);
+			return 1;
+		}
+
+		base.chop(QFileInfo(base).suffix().size() + 1);
+
+		for (int dpr : dprs) {
+			QString name = base + (dpr == 1 ? QString() : QStringLiteral("@%1x").arg(dpr))
+				+ QStringLiteral(".png");
+			QImage image(renderer.defaultSize() * dpr,
+				     QImage::Format_ARGB32_Premultiplied);
+
+			image.fill(Qt::transparent);
+			QPainter painter(&image);
+			renderer.render(&painter);
+			painter.end();
+
+			output_dir.mkpath(QFileInfo(name).path());
+			if (!image.save(output_dir.filePath(name))) {
+				fprintf(stderr, "Unable to write %s\n", qPrintable(name));
+				return 1;
+			}
+
+			out << "        <file>" << name << "</file>\n";
+		}
+	}
+
+	out << "    </qresource>\n</RCC>\n";
+	out.flush();
+
+	return qrc.error() == QFileDevice::NoError ? 0 : 1;
+}